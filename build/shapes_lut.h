@@ -0,0 +1,271 @@
+// THIS FILE IS AUTOGENERATED //
+// DO NOT EDIT THIS MANUALLY //
+
+#pragma once
+
+#define SHAPES_LUT_SIZE 512
+
+static const float shapes_lut_sin[SHAPES_LUT_SIZE+1] =
+    { -0.000000000e+00, 9.412358699e-06, 3.764908043e-05, 8.470910209e-05
+    , 1.505906519e-04, 2.352912495e-04, 3.388077058e-04, 4.611361237e-04
+    , 6.022718974e-04, 7.622097134e-04, 9.409435499e-04, 1.138466678e-03
+    , 1.354771661e-03, 1.589850354e-03, 1.843693909e-03, 2.116292766e-03
+    , 2.407636664e-03, 2.717714633e-03, 3.046514999e-03, 3.394025383e-03
+    , 3.760232701e-03, 4.145123165e-03, 4.548682286e-03, 4.970894869e-03
+    , 5.411745018e-03, 5.871216135e-03, 6.349290921e-03, 6.845951378e-03
+    , 7.361178806e-03, 7.894953807e-03, 8.447256284e-03, 9.018065445e-03
+    , 9.607359798e-03, 1.021511716e-02, 1.084131464e-02, 1.148592867e-02
+    , 1.214893498e-02, 1.283030861e-02, 1.353002390e-02, 1.424805451e-02
+    , 1.498437340e-02, 1.573895286e-02, 1.651176448e-02, 1.730277915e-02
+    , 1.811196710e-02, 1.893929787e-02, 1.978474029e-02, 2.064826255e-02
+    , 2.152983213e-02, 2.242941585e-02, 2.334697982e-02, 2.428248952e-02
+    , 2.523590970e-02, 2.620720449e-02, 2.719633731e-02, 2.820327092e-02
+    , 2.922796741e-02, 3.027038820e-02, 3.133049404e-02, 3.240824503e-02
+    , 3.350360058e-02, 3.461651946e-02, 3.574695976e-02, 3.689487893e-02
+    , 3.806023374e-02, 3.924298033e-02, 4.044307415e-02, 4.166047004e-02
+    , 4.289512215e-02, 4.414698400e-02, 4.541600845e-02, 4.670214774e-02
+    , 4.800535344e-02, 4.932557648e-02, 5.066276715e-02, 5.201687512e-02
+    , 5.338784940e-02, 5.477563838e-02, 5.618018980e-02, 5.760145078e-02
+    , 5.903936783e-02, 6.049388679e-02, 6.196495290e-02, 6.345251079e-02
+    , 6.495650445e-02, 6.647687724e-02, 6.801357194e-02, 6.956653068e-02
+    , 7.113569500e-02, 7.272100582e-02, 7.432240345e-02, 7.593982760e-02
+    , 7.757321738e-02, 7.922251128e-02, 8.088764722e-02, 8.256856251e-02
+    , 8.426519385e-02, 8.597747737e-02, 8.770534861e-02, 8.944874250e-02
+    , 9.120759342e-02, 9.298183515e-02, 9.477140087e-02, 9.657622323e-02
+    , 9.839623426e-02, 1.002313654e-01, 1.020815477e-01, 1.039467113e-01
+    , 1.058267862e-01, 1.077217014e-01, 1.096313857e-01, 1.115557672e-01
+    , 1.134947733e-01, 1.154483312e-01, 1.174163672e-01, 1.193988073e-01
+    , 1.213955767e-01, 1.234066005e-01, 1.254318027e-01, 1.274711073e-01
+    , 1.295244373e-01, 1.315917156e-01, 1.336728642e-01, 1.357678048e-01
+    , 1.378764585e-01, 1.399987460e-01, 1.421345874e-01, 1.442839021e-01
+    , 1.464466094e-01, 1.486226278e-01, 1.508118753e-01, 1.530142696e-01
+    , 1.552297276e-01, 1.574581661e-01, 1.596995011e-01, 1.619536482e-01
+    , 1.642205226e-01, 1.665000388e-01, 1.687921112e-01, 1.710966534e-01
+    , 1.734135785e-01, 1.757427995e-01, 1.780842286e-01, 1.804377776e-01
+    , 1.828033579e-01, 1.851808805e-01, 1.875702559e-01, 1.899713941e-01
+    , 1.923842047e-01, 1.948085969e-01, 1.972444793e-01, 1.996917603e-01
+    , 2.021503478e-01, 2.046201491e-01, 2.071010713e-01, 2.095930210e-01
+    , 2.120959043e-01, 2.146096271e-01, 2.171340946e-01, 2.196692119e-01
+    , 2.222148835e-01, 2.247710135e-01, 2.273375058e-01, 2.299142636e-01
+    , 2.325011901e-01, 2.350981877e-01, 2.377051587e-01, 2.403220049e-01
+    , 2.429486279e-01, 2.455849287e-01, 2.482308081e-01, 2.508861665e-01
+    , 2.535509039e-01, 2.562249199e-01, 2.589081140e-01, 2.616003850e-01
+    , 2.643016316e-01, 2.670117521e-01, 2.697306445e-01, 2.724582064e-01
+    , 2.751943352e-01, 2.779389277e-01, 2.806918807e-01, 2.834530906e-01
+    , 2.862224533e-01, 2.889998646e-01, 2.917852200e-01, 2.945784145e-01
+    , 2.973793430e-01, 3.001879001e-01, 3.030039800e-01, 3.058274767e-01
+    , 3.086582838e-01, 3.114962949e-01, 3.143414030e-01, 3.171935011e-01
+    , 3.200524817e-01, 3.229182373e-01, 3.257906599e-01, 3.286696413e-01
+    , 3.315550733e-01, 3.344468471e-01, 3.373448539e-01, 3.402489846e-01
+    , 3.431591298e-01, 3.460751800e-01, 3.489970253e-01, 3.519245559e-01
+    , 3.548576614e-01, 3.577962314e-01, 3.607401553e-01, 3.636893223e-01
+    , 3.666436213e-01, 3.696029410e-01, 3.725671702e-01, 3.755361971e-01
+    , 3.785099100e-01, 3.814881970e-01, 3.844709459e-01, 3.874580443e-01
+    , 3.904493799e-01, 3.934448400e-01, 3.964443119e-01, 3.994476826e-01
+    , 4.024548390e-01, 4.054656679e-01, 4.084800560e-01, 4.114978898e-01
+    , 4.145190556e-01, 4.175434398e-01, 4.205709283e-01, 4.236014074e-01
+    , 4.266347628e-01, 4.296708803e-01, 4.327096457e-01, 4.357509446e-01
+    , 4.387946624e-01, 4.418406845e-01, 4.448888964e-01, 4.479391831e-01
+    , 4.509914298e-01, 4.540455218e-01, 4.571013438e-01, 4.601587810e-01
+    , 4.632177182e-01, 4.662780402e-01, 4.693396318e-01, 4.724023778e-01
+    , 4.754661628e-01, 4.785308715e-01, 4.815963885e-01, 4.846625984e-01
+    , 4.877293857e-01, 4.907966350e-01, 4.938642309e-01, 4.969320577e-01
+    , 5.000000000e-01, 5.030679423e-01, 5.061357691e-01, 5.092033650e-01
+    , 5.122706143e-01, 5.153374016e-01, 5.184036115e-01, 5.214691285e-01
+    , 5.245338372e-01, 5.275976222e-01, 5.306603682e-01, 5.337219598e-01
+    , 5.367822818e-01, 5.398412190e-01, 5.428986562e-01, 5.459544782e-01
+    , 5.490085702e-01, 5.520608169e-01, 5.551111036e-01, 5.581593155e-01
+    , 5.612053376e-01, 5.642490554e-01, 5.672903543e-01, 5.703291197e-01
+    , 5.733652372e-01, 5.763985926e-01, 5.794290717e-01, 5.824565602e-01
+    , 5.854809444e-01, 5.885021102e-01, 5.915199440e-01, 5.945343321e-01
+    , 5.975451610e-01, 6.005523174e-01, 6.035556881e-01, 6.065551600e-01
+    , 6.095506201e-01, 6.125419557e-01, 6.155290541e-01, 6.185118030e-01
+    , 6.214900900e-01, 6.244638029e-01, 6.274328298e-01, 6.303970590e-01
+    , 6.333563787e-01, 6.363106777e-01, 6.392598447e-01, 6.422037686e-01
+    , 6.451423386e-01, 6.480754441e-01, 6.510029747e-01, 6.539248200e-01
+    , 6.568408702e-01, 6.597510154e-01, 6.626551461e-01, 6.655531529e-01
+    , 6.684449267e-01, 6.713303587e-01, 6.742093401e-01, 6.770817627e-01
+    , 6.799475183e-01, 6.828064989e-01, 6.856585970e-01, 6.885037051e-01
+    , 6.913417162e-01, 6.941725233e-01, 6.969960200e-01, 6.998120999e-01
+    , 7.026206570e-01, 7.054215855e-01, 7.082147800e-01, 7.110001354e-01
+    , 7.137775467e-01, 7.165469094e-01, 7.193081193e-01, 7.220610723e-01
+    , 7.248056648e-01, 7.275417936e-01, 7.302693555e-01, 7.329882479e-01
+    , 7.356983684e-01, 7.383996150e-01, 7.410918860e-01, 7.437750801e-01
+    , 7.464490961e-01, 7.491138335e-01, 7.517691919e-01, 7.544150713e-01
+    , 7.570513721e-01, 7.596779951e-01, 7.622948413e-01, 7.649018123e-01
+    , 7.674988099e-01, 7.700857364e-01, 7.726624942e-01, 7.752289865e-01
+    , 7.777851165e-01, 7.803307881e-01, 7.828659054e-01, 7.853903729e-01
+    , 7.879040957e-01, 7.904069790e-01, 7.928989287e-01, 7.953798509e-01
+    , 7.978496522e-01, 8.003082397e-01, 8.027555207e-01, 8.051914031e-01
+    , 8.076157953e-01, 8.100286059e-01, 8.124297441e-01, 8.148191195e-01
+    , 8.171966421e-01, 8.195622224e-01, 8.219157714e-01, 8.242572005e-01
+    , 8.265864215e-01, 8.289033466e-01, 8.312078888e-01, 8.334999612e-01
+    , 8.357794774e-01, 8.380463518e-01, 8.403004989e-01, 8.425418339e-01
+    , 8.447702724e-01, 8.469857304e-01, 8.491881247e-01, 8.513773722e-01
+    , 8.535533906e-01, 8.557160979e-01, 8.578654126e-01, 8.600012540e-01
+    , 8.621235415e-01, 8.642321952e-01, 8.663271358e-01, 8.684082844e-01
+    , 8.704755627e-01, 8.725288927e-01, 8.745681973e-01, 8.765933995e-01
+    , 8.786044233e-01, 8.806011927e-01, 8.825836328e-01, 8.845516688e-01
+    , 8.865052267e-01, 8.884442328e-01, 8.903686143e-01, 8.922782986e-01
+    , 8.941732138e-01, 8.960532887e-01, 8.979184523e-01, 8.997686346e-01
+    , 9.016037657e-01, 9.034237768e-01, 9.052285991e-01, 9.070181649e-01
+    , 9.087924066e-01, 9.105512575e-01, 9.122946514e-01, 9.140225226e-01
+    , 9.157348062e-01, 9.174314375e-01, 9.191123528e-01, 9.207774887e-01
+    , 9.224267826e-01, 9.240601724e-01, 9.256775966e-01, 9.272789942e-01
+    , 9.288643050e-01, 9.304334693e-01, 9.319864281e-01, 9.335231228e-01
+    , 9.350434956e-01, 9.365474892e-01, 9.380350471e-01, 9.395061132e-01
+    , 9.409606322e-01, 9.423985492e-01, 9.438198102e-01, 9.452243616e-01
+    , 9.466121506e-01, 9.479831249e-01, 9.493372328e-01, 9.506744235e-01
+    , 9.519946466e-01, 9.532978523e-01, 9.545839915e-01, 9.558530160e-01
+    , 9.571048779e-01, 9.583395300e-01, 9.595569258e-01, 9.607570197e-01
+    , 9.619397663e-01, 9.631051211e-01, 9.642530402e-01, 9.653834805e-01
+    , 9.664963994e-01, 9.675917550e-01, 9.686695060e-01, 9.697296118e-01
+    , 9.707720326e-01, 9.717967291e-01, 9.728036627e-01, 9.737927955e-01
+    , 9.747640903e-01, 9.757175105e-01, 9.766530202e-01, 9.775705842e-01
+    , 9.784701679e-01, 9.793517374e-01, 9.802152597e-01, 9.810607021e-01
+    , 9.818880329e-01, 9.826972208e-01, 9.834882355e-01, 9.842610471e-01
+    , 9.850156266e-01, 9.857519455e-01, 9.864699761e-01, 9.871696914e-01
+    , 9.878510650e-01, 9.885140713e-01, 9.891586854e-01, 9.897848828e-01
+    , 9.903926402e-01, 9.909819346e-01, 9.915527437e-01, 9.921050462e-01
+    , 9.926388212e-01, 9.931540486e-01, 9.936507091e-01, 9.941287839e-01
+    , 9.945882550e-01, 9.950291051e-01, 9.954513177e-01, 9.958548768e-01
+    , 9.962397673e-01, 9.966059746e-01, 9.969534850e-01, 9.972822854e-01
+    , 9.975923633e-01, 9.978837072e-01, 9.981563061e-01, 9.984101496e-01
+    , 9.986452283e-01, 9.988615333e-01, 9.990590565e-01, 9.992377903e-01
+    , 9.993977281e-01, 9.995388639e-01, 9.996611923e-01, 9.997647088e-01
+    , 9.998494093e-01, 9.999152909e-01, 9.999623509e-01, 9.999905876e-01
+    , 1.000000000e+00
+    };
+
+static const float shapes_lut_exp[SHAPES_LUT_SIZE+1] =
+    { 9.765625000e-04, 9.898731298e-04, 1.003365185e-03, 1.017041137e-03
+    , 1.030903494e-03, 1.044954797e-03, 1.059197619e-03, 1.073634573e-03
+    , 1.088268303e-03, 1.103101493e-03, 1.118136860e-03, 1.133377160e-03
+    , 1.148825187e-03, 1.164483772e-03, 1.180355785e-03, 1.196444134e-03
+    , 1.212751770e-03, 1.229281679e-03, 1.246036893e-03, 1.263020482e-03
+    , 1.280235558e-03, 1.297685278e-03, 1.315372838e-03, 1.333301482e-03
+    , 1.351474494e-03, 1.369895206e-03, 1.388566994e-03, 1.407493280e-03
+    , 1.426677533e-03, 1.446123269e-03, 1.465834052e-03, 1.485813495e-03
+    , 1.506065259e-03, 1.526593057e-03, 1.547400650e-03, 1.568491852e-03
+    , 1.589870529e-03, 1.611540600e-03, 1.633506035e-03, 1.655770861e-03
+    , 1.678339158e-03, 1.701215064e-03, 1.724402769e-03, 1.747906526e-03
+    , 1.771730640e-03, 1.795879479e-03, 1.820357469e-03, 1.845169096e-03
+    , 1.870318908e-03, 1.895811513e-03, 1.921651585e-03, 1.947843860e-03
+    , 1.974393137e-03, 2.001304283e-03, 2.028582230e-03, 2.056231979e-03
+    , 2.084258595e-03, 2.112667217e-03, 2.141463050e-03, 2.170651374e-03
+    , 2.200237536e-03, 2.230226961e-03, 2.260625144e-03, 2.291437657e-03
+    , 2.322670146e-03, 2.354328338e-03, 2.386418033e-03, 2.418945114e-03
+    , 2.451915541e-03, 2.485335358e-03, 2.519210690e-03, 2.553547746e-03
+    , 2.588352819e-03, 2.623632287e-03, 2.659392618e-03, 2.695640366e-03
+    , 2.732382173e-03, 2.769624774e-03, 2.807374995e-03, 2.845639755e-03
+    , 2.884426066e-03, 2.923741039e-03, 2.963591877e-03, 3.003985886e-03
+    , 3.044930469e-03, 3.086433130e-03, 3.128501476e-03, 3.171143217e-03
+    , 3.214366168e-03, 3.258178252e-03, 3.302587499e-03, 3.347602047e-03
+    , 3.393230147e-03, 3.439480162e-03, 3.486360569e-03, 3.533879960e-03
+    , 3.582047044e-03, 3.630870649e-03, 3.680359725e-03, 3.730523340e-03
+    , 3.781370690e-03, 3.832911094e-03, 3.885153998e-03, 3.938108977e-03
+    , 3.991785737e-03, 4.046194116e-03, 4.101344085e-03, 4.157245753e-03
+    , 4.213909366e-03, 4.271345309e-03, 4.329564108e-03, 4.388576435e-03
+    , 4.448393105e-03, 4.509025080e-03, 4.570483475e-03, 4.632779553e-03
+    , 4.695924732e-03, 4.759930585e-03, 4.824808844e-03, 4.890571398e-03
+    , 4.957230302e-03, 5.024797772e-03, 5.093286192e-03, 5.162708116e-03
+    , 5.233076266e-03, 5.304403540e-03, 5.376703011e-03, 5.449987930e-03
+    , 5.524271728e-03, 5.599568021e-03, 5.675890609e-03, 5.753253480e-03
+    , 5.831670814e-03, 5.911156982e-03, 5.991726554e-03, 6.073394296e-03
+    , 6.156175176e-03, 6.240084367e-03, 6.325137247e-03, 6.411349405e-03
+    , 6.498736642e-03, 6.587314974e-03, 6.677100637e-03, 6.768110086e-03
+    , 6.860360001e-03, 6.953867291e-03, 7.048649093e-03, 7.144722779e-03
+    , 7.242105957e-03, 7.340816477e-03, 7.440872429e-03, 7.542292152e-03
+    , 7.645094235e-03, 7.749297519e-03, 7.854921102e-03, 7.961984344e-03
+    , 8.070506867e-03, 8.180508562e-03, 8.292009588e-03, 8.405030383e-03
+    , 8.519591661e-03, 8.635714420e-03, 8.753419941e-03, 8.872729798e-03
+    , 8.993665859e-03, 9.116250289e-03, 9.240505555e-03, 9.366454430e-03
+    , 9.494120000e-03, 9.623525662e-03, 9.754695134e-03, 9.887652458e-03
+    , 1.002242200e-02, 1.015902846e-02, 1.029749688e-02, 1.043785264e-02
+    , 1.058012146e-02, 1.072432941e-02, 1.087050294e-02, 1.101866881e-02
+    , 1.116885421e-02, 1.132108664e-02, 1.147539401e-02, 1.163180461e-02
+    , 1.179034709e-02, 1.195105052e-02, 1.211394436e-02, 1.227905845e-02
+    , 1.244642306e-02, 1.261606886e-02, 1.278802695e-02, 1.296232885e-02
+    , 1.313900649e-02, 1.331809226e-02, 1.349961899e-02, 1.368361995e-02
+    , 1.387012885e-02, 1.405917988e-02, 1.425080770e-02, 1.444504742e-02
+    , 1.464193464e-02, 1.484150545e-02, 1.504379643e-02, 1.524884466e-02
+    , 1.545668771e-02, 1.566736367e-02, 1.588091117e-02, 1.609736934e-02
+    , 1.631677785e-02, 1.653917692e-02, 1.676460731e-02, 1.699311033e-02
+    , 1.722472786e-02, 1.745950237e-02, 1.769747687e-02, 1.793869498e-02
+    , 1.818320092e-02, 1.843103949e-02, 1.868225613e-02, 1.893689686e-02
+    , 1.919500838e-02, 1.945663797e-02, 1.972183360e-02, 1.999064387e-02
+    , 2.026311804e-02, 2.053930606e-02, 2.081925855e-02, 2.110302681e-02
+    , 2.139066286e-02, 2.168221941e-02, 2.197774990e-02, 2.227730850e-02
+    , 2.258095011e-02, 2.288873038e-02, 2.320070572e-02, 2.351693331e-02
+    , 2.383747111e-02, 2.416237786e-02, 2.449171312e-02, 2.482553725e-02
+    , 2.516391144e-02, 2.550689769e-02, 2.585455887e-02, 2.620695870e-02
+    , 2.656416178e-02, 2.692623356e-02, 2.729324041e-02, 2.766524959e-02
+    , 2.804232930e-02, 2.842454863e-02, 2.881197764e-02, 2.920468734e-02
+    , 2.960274971e-02, 3.000623771e-02, 3.041522527e-02, 3.082978738e-02
+    , 3.125000000e-02, 3.167594015e-02, 3.210768591e-02, 3.254531640e-02
+    , 3.298891182e-02, 3.343855349e-02, 3.389432382e-02, 3.435630633e-02
+    , 3.482458571e-02, 3.529924777e-02, 3.578037951e-02, 3.626806913e-02
+    , 3.676240599e-02, 3.726348071e-02, 3.777138511e-02, 3.828621230e-02
+    , 3.880805663e-02, 3.933701374e-02, 3.987318057e-02, 4.041665541e-02
+    , 4.096753786e-02, 4.152592888e-02, 4.209193082e-02, 4.266564741e-02
+    , 4.324718381e-02, 4.383664660e-02, 4.443414382e-02, 4.503978497e-02
+    , 4.565368107e-02, 4.627594462e-02, 4.690668968e-02, 4.754603184e-02
+    , 4.819408829e-02, 4.885097781e-02, 4.951682079e-02, 5.019173926e-02
+    , 5.087585693e-02, 5.156929919e-02, 5.227219311e-02, 5.298466755e-02
+    , 5.370685307e-02, 5.443888204e-02, 5.518088862e-02, 5.593300882e-02
+    , 5.669538048e-02, 5.746814334e-02, 5.825143901e-02, 5.904541107e-02
+    , 5.985020504e-02, 6.066596842e-02, 6.149285073e-02, 6.233100351e-02
+    , 6.318058038e-02, 6.404173706e-02, 6.491463137e-02, 6.579942331e-02
+    , 6.669627504e-02, 6.760535094e-02, 6.852681761e-02, 6.946084396e-02
+    , 7.040760116e-02, 7.136726275e-02, 7.234000460e-02, 7.332600501e-02
+    , 7.432544469e-02, 7.533850681e-02, 7.636537706e-02, 7.740624364e-02
+    , 7.846129731e-02, 7.953073146e-02, 8.061474209e-02, 8.171352787e-02
+    , 8.282729020e-02, 8.395623320e-02, 8.510056379e-02, 8.626049170e-02
+    , 8.743622953e-02, 8.862799277e-02, 8.983599984e-02, 9.106047215e-02
+    , 9.230163412e-02, 9.355971324e-02, 9.483494007e-02, 9.612754836e-02
+    , 9.743777501e-02, 9.876586017e-02, 1.001120472e-01, 1.014765829e-01
+    , 1.028597174e-01, 1.042617041e-01, 1.056828000e-01, 1.071232655e-01
+    , 1.085833647e-01, 1.100633652e-01, 1.115635382e-01, 1.130841587e-01
+    , 1.146255054e-01, 1.161878608e-01, 1.177715112e-01, 1.193767469e-01
+    , 1.210038621e-01, 1.226531550e-01, 1.243249279e-01, 1.260194873e-01
+    , 1.277371436e-01, 1.294782117e-01, 1.312430107e-01, 1.330318641e-01
+    , 1.348450997e-01, 1.366830499e-01, 1.385460515e-01, 1.404344459e-01
+    , 1.423485793e-01, 1.442888026e-01, 1.462554712e-01, 1.482489457e-01
+    , 1.502695914e-01, 1.523177787e-01, 1.543938830e-01, 1.564982847e-01
+    , 1.586313696e-01, 1.607935287e-01, 1.629851581e-01, 1.652066597e-01
+    , 1.674584405e-01, 1.697409133e-01, 1.720544963e-01, 1.743996137e-01
+    , 1.767766953e-01, 1.791861767e-01, 1.816284995e-01, 1.841041114e-01
+    , 1.866134660e-01, 1.891570234e-01, 1.917352497e-01, 1.943486175e-01
+    , 1.969976056e-01, 1.996826997e-01, 2.024043919e-01, 2.051631810e-01
+    , 2.079595725e-01, 2.107940792e-01, 2.136672204e-01, 2.165795228e-01
+    , 2.195315200e-01, 2.225237533e-01, 2.255567710e-01, 2.286311289e-01
+    , 2.317473906e-01, 2.349061273e-01, 2.381079177e-01, 2.413533489e-01
+    , 2.446430155e-01, 2.479775206e-01, 2.513574753e-01, 2.547834990e-01
+    , 2.582562198e-01, 2.617762740e-01, 2.653443068e-01, 2.689609723e-01
+    , 2.726269332e-01, 2.763428614e-01, 2.801094381e-01, 2.839273535e-01
+    , 2.877973075e-01, 2.917200092e-01, 2.956961777e-01, 2.997265418e-01
+    , 3.038118400e-01, 3.079528212e-01, 3.121502443e-01, 3.164048786e-01
+    , 3.207175040e-01, 3.250889108e-01, 3.295199003e-01, 3.340112846e-01
+    , 3.385638867e-01, 3.431785413e-01, 3.478560939e-01, 3.525974021e-01
+    , 3.574033346e-01, 3.622747724e-01, 3.672126083e-01, 3.722177474e-01
+    , 3.772911069e-01, 3.824336167e-01, 3.876462194e-01, 3.929298703e-01
+    , 3.982855378e-01, 4.037142036e-01, 4.092168624e-01, 4.147945230e-01
+    , 4.204482076e-01, 4.261789524e-01, 4.319878077e-01, 4.378758383e-01
+    , 4.438441231e-01, 4.498937562e-01, 4.560258464e-01, 4.622415174e-01
+    , 4.685419085e-01, 4.749281745e-01, 4.814014859e-01, 4.879630291e-01
+    , 4.946140066e-01, 5.013556375e-01, 5.081891575e-01, 5.151158188e-01
+    , 5.221368912e-01, 5.292536614e-01, 5.364674338e-01, 5.437795305e-01
+    , 5.511912917e-01, 5.587040758e-01, 5.663192598e-01, 5.740382394e-01
+    , 5.818624294e-01, 5.897932637e-01, 5.978321960e-01, 6.059806996e-01
+    , 6.142402681e-01, 6.226124151e-01, 6.310986752e-01, 6.397006038e-01
+    , 6.484197773e-01, 6.572577940e-01, 6.662162735e-01, 6.752968579e-01
+    , 6.845012115e-01, 6.938310211e-01, 7.032879969e-01, 7.128738721e-01
+    , 7.225904035e-01, 7.324393721e-01, 7.424225829e-01, 7.525418658e-01
+    , 7.627990754e-01, 7.731960916e-01, 7.837348200e-01, 7.944171922e-01
+    , 8.052451660e-01, 8.162207260e-01, 8.273458838e-01, 8.386226785e-01
+    , 8.500531769e-01, 8.616394739e-01, 8.733836931e-01, 8.852879870e-01
+    , 8.973545375e-01, 9.095855561e-01, 9.219832845e-01, 9.345499950e-01
+    , 9.472879908e-01, 9.601996066e-01, 9.732872088e-01, 9.865531961e-01
+    , 1.000000000e+00
+    };
+
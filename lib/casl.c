@@ -2,23 +2,155 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h> // memcpy
 #include <math.h> // floorf
 
 #include "caw.h" // Caw_printf
 
 #include "lualink.h" // L_queue_asl_done for raising a sequence-complete event
+#include "events.h"  // event_post() for deferring segment resolution
+#include "stm32f7xx.h" // BLOCK_IRQS
+#include "../ll/random.h" // Random_Float() buffered from the hardware RNG
 
 // TODO
-// add sequins data type
-// add random math operator
 // dynamics should be available for SHAPEs (though not mutables)
-// switch to a pooled memory store to enable more complex ASLs to borrow memory from cheap ones
 
-#define SELVES_COUNT 4
+#define SELVES_COUNT SLOPE_CHANNELS // outputs + virtuals
 static Casl* _selves[SELVES_COUNT];
 
+// shared node pools. nodes are tagged with their owner so a channel can
+// borrow more than its share, and reclaim only its own on re-description
+static To       tos[TO_COUNT];
+static Sequence seqs[SEQ_COUNT];
+static Elem     dynamics[DYN_COUNT];
+static CaslOp   code[CODE_COUNT];
+
+static int8_t to_owner[TO_COUNT]   = {[0 ... TO_COUNT-1]=-1};
+static int8_t seq_owner[SEQ_COUNT] = {[0 ... SEQ_COUNT-1]=-1};
+static int8_t dyn_owner[DYN_COUNT] = {[0 ... DYN_COUNT-1]=-1};
+static int8_t code_owner[CODE_COUNT] = {[0 ... CODE_COUNT-1]=-1};
+
+// bumped as a dynamic is freed. handles given to Lua carry it, so a handle
+// kept past a reclaim can't write to the slot's next owner
+static uint8_t dyn_gen[DYN_COUNT];
+#if DYN_COUNT > 256
+#error "dynamic handles pack the slot & its 8bit generation into 16 bits"
+#endif
+
+typedef struct{
+    int8_t* owner; // -1 when free
+    uint8_t* gen;  // bumped on free. NULL if the pool's nodes aren't handed out
+    int     size;
+    int     used;
+    int     high;
+    int     owned[SELVES_COUNT];
+} Pool;
+
+static Pool pools[CaslPool_Count] =
+    { [CaslPool_To]  = { .owner = to_owner,  .size = TO_COUNT  }
+    , [CaslPool_Seq] = { .owner = seq_owner, .size = SEQ_COUNT }
+    , [CaslPool_Dyn] = { .owner = dyn_owner, .gen = dyn_gen, .size = DYN_COUNT }
+    , [CaslPool_Code] = { .owner = code_owner, .size = CODE_COUNT }
+    };
+
+// returns index of the first of count contiguous nodes, or -1 if pool is exhausted
+static int pool_alloc_run( CaslPool p, int owner, int count )
+{
+    Pool* pool = &pools[p];
+    if( pool->used + count > pool->size ){ return -1; }
+    int run = 0;
+    for( int i=0; i<pool->size; i++ ){
+        run = (pool->owner[i] < 0) ? run+1 : 0;
+        if( run == count ){
+            int first = i - count + 1;
+            for( int j=first; j<=i; j++ ){ pool->owner[j] = owner; }
+            pool->owned[owner] += count;
+            pool->used += count;
+            if( pool->used > pool->high ){ pool->high = pool->used; }
+            return first;
+        }
+    }
+    return -1;
+}
+
+static int pool_alloc( CaslPool p, int owner )
+{
+    return pool_alloc_run(p, owner, 1);
+}
+
+static void pool_free( CaslPool p, int ix )
+{
+    Pool* pool = &pools[p];
+    int owner = pool->owner[ix];
+    if( owner < 0 ){ return; }
+    pool->owner[ix] = -1;
+    if( pool->gen ){ pool->gen[ix]++; }
+    pool->owned[owner]--;
+    pool->used--;
+}
+
+static void pool_reclaim( CaslPool p, int owner )
+{
+    Pool* pool = &pools[p];
+    if( pool->owned[owner] == 0 ){ return; }
+    for( int i=0; i<pool->size; i++ ){
+        if( pool->owner[i] == owner ){
+            pool->owner[i] = -1;
+            if( pool->gen ){ pool->gen[i]++; }
+        }
+    }
+    pool->used -= pool->owned[owner];
+    pool->owned[owner] = 0;
+}
+
+// a dynamic as Lua refers to it: the slot & its generation
+static int dyn_handle( int ix )
+{
+    return dyn_gen[ix] * DYN_COUNT + ix;
+}
+
+// slot of a handle, or -1 if the slot has been freed since or isn't index's
+static int dyn_slot( int index, int handle )
+{
+    if( handle < 0 ){ return -1; }
+    int ix = handle % DYN_COUNT;
+    if( handle / DYN_COUNT != dyn_gen[ix] ){ return -1; }
+    if( dyn_owner[ix] != index ){ return -1; }
+    return ix;
+}
+
+CaslPoolStats casl_arena_stats( CaslPool pool )
+{
+    if( pool < 0 || pool >= CaslPool_Count ){ return (CaslPoolStats){0,0,0}; }
+    Pool* p = &pools[pool];
+    return (CaslPoolStats){ .size = p->size
+                          , .used = p->used
+                          , .high = p->high
+                          };
+}
+
+int casl_arena_owned( int index, CaslPool pool )
+{
+    if(index < 0 || index >= SELVES_COUNT){ return 0; }
+    if( pool < 0 || pool >= CaslPool_Count ){ return 0; }
+    return pools[pool].owned[index];
+}
+
+// every Sequence of a channel restarts from its first stage
+static void seq_reset_all( Casl* self )
+{
+    for( int i=0; i<SEQ_COUNT; i++ ){
+        if( seq_owner[i] == self->index ){ seqs[i].pc = seqs[i].head; }
+    }
+}
+
 
 static int casl_defdynamicP( Casl* self );
+static void compile_all( Casl* self );
+static int optimize( Casl* self );
+static To* to_alloc( Casl* self );
+static void request_prefetch( int index );
+static void rewind_prefetch( Casl* self );
 
 
 Casl* casl_init( int index )
@@ -30,72 +162,167 @@ Casl* casl_init( int index )
 
     _selves[index] = self; // save ref for indexed lookup
 
-    self->to_ix = 0; // To* allocation count
-    self->seq_current = &self->seqs[0];
-    self->seq_ix  = 0;  // counts up allocation of Sequence slots
+    self->index = index;
+    self->seq_current = NULL; // nothing described
+    self->seq_root = -1;
     self->seq_select = -1; // current 'parent'
-    self->dyn_ix = 0;
 
     self->holding = false;
     self->locked = false;
+    self->prefetching = false;
+    self->acting = false;
+    self->ahead = 0;
+    self->played = CASL_NIL;
+    self->optimized = 0;
+    self->direct = CASL_NIL;
+
+    S_set_refill( index, &request_prefetch );
 
     return self;
 }
 
-static void seq_enter( Casl* self )
+static bool seq_enter( Casl* self )
 {
-    if(self->seq_ix >= SEQ_COUNT){
+    int ix = pool_alloc(CaslPool_Seq, self->index);
+    if(ix < 0){
         printf("ERROR: no sequences left!\n");
         Caw_printf("ERROR: no sequences left!\n");
-        return;
+        return false;
     }
-    Sequence* s = &self->seqs[self->seq_ix];
+    Sequence* s = &seqs[ix];
     self->seq_current = s; // save as 'active' Sequence
 
+    s->head   = CASL_NIL;
+    s->tail   = CASL_NIL;
+    s->pc     = CASL_NIL;
     s->length = 0;
-    s->pc     = 0;
     s->parent = self->seq_select;
 
-    self->seq_select = self->seq_ix; // select the new Sequence
-    self->seq_ix++; // marks the sequence as allocated
+    self->seq_select = ix; // select the new Sequence
+    return true;
 }
 
 static void seq_exit( Casl* self )
 {
     self->seq_select = self->seq_current->parent; // move up tree
-    self->seq_current = &self->seqs[self->seq_select]; // save the new node
+    self->seq_current = &seqs[self->seq_select]; // save the new node
 }
 
 static void seq_append( Casl* self, To* t )
 {
     Sequence* s = self->seq_current;
-    if(s->length >= SEQ_LENGTH){
-        printf("ERROR: no stages left!\n");
-        Caw_printf("ERROR: no stages left!\n");
+    uint16_t ix = t - tos;
+    t->next = CASL_NIL;
+    if(s->head == CASL_NIL){
+        s->head = ix;
+        s->pc   = ix; // ready to run from the first stage
+    } else {
+        tos[s->tail].next = ix; // append To* to end of Sequence
     }
-    s->stage[s->length] = t; // append To* to end of Sequence
+    s->tail = ix;
     s->length++;
 }
 
 static void parse_table( Casl* self, lua_State* L );
-void casl_describe( int index, lua_State* L )
+typedef struct{
+    const uint8_t* p;
+    const uint8_t* end;
+    bool err; // truncated or malformed. parsing stops
+} Reader;
+static void bin_stage( Casl* self, Reader* r );
+// clear the old description & enter an empty root Sequence
+static bool describe_begin( Casl* self )
 {
-    if(index < 0 || index >= SELVES_COUNT){ return; }
-    Casl* self = _selves[index];
+    S_queue_clear(self->index); // queued segments belong to the old description
+    self->ahead = 0;
 
-    // deallocate everything
-    self->to_ix  = 0;
-    self->seq_ix = 0;
+    // return this channel's nodes to the shared pools
+    pool_reclaim(CaslPool_To, self->index);
+    pool_reclaim(CaslPool_Seq, self->index);
+    pool_reclaim(CaslPool_Code, self->index);
+    self->seq_current = NULL;
+    self->seq_root = -1;
     self->seq_select = -1; // current 'parent'
-    // reset all sequences
-    self->seq_current = &self->seqs[0]; // first sequence
-    for(int i=0; i<SEQ_COUNT; i++){ self->seqs[i].pc = 0; } // reset all program counters
+    self->direct = CASL_NIL;
 
     // enter first sequence
-    seq_enter(self);
+    if( !seq_enter(self) ){ return false; } // pool exhausted
+    self->seq_root = self->seq_select;
+    return true;
+}
+
+void casl_describe( int index, lua_State* L )
+{
+    if(index < 0 || index >= SELVES_COUNT){ return; }
+    Casl* self = _selves[index];
+
+    if( !describe_begin(self) ){ return; }
 
     parse_table(self, L);
     // seq_exit(self)? // i think we want to start inside the first Seq anyway
+
+    self->optimized = optimize(self);
+    compile_all(self);
+}
+
+void casl_describe_bin( int index, const char* data, size_t len )
+{
+    if(index < 0 || index >= SELVES_COUNT){ return; }
+    Casl* self = _selves[index];
+
+    if( !describe_begin(self) ){ return; }
+
+    Reader r = { .p   = (const uint8_t*)data
+               , .end = (const uint8_t*)data + len
+               , .err = false
+               };
+    bin_stage(self, &r);
+    if( r.err || r.p != r.end ){
+        printf("ERROR: malformed binary ASL\n");
+        Caw_printf("ERROR: malformed binary ASL\n");
+    }
+
+    self->optimized = optimize(self);
+    compile_all(self);
+}
+
+// equivalent to describe(to(volts, seconds, shape)) followed by action()
+// the single To is built once, then only its values are replaced
+void casl_to( int index, float volts, float seconds, Shape_t shape )
+{
+    if(index < 0 || index >= SELVES_COUNT){ return; }
+    Casl* self = _selves[index];
+
+    if( self->direct == CASL_NIL ){
+        pool_reclaim(CaslPool_Dyn, index); // as describe does via cleardynamics
+        if( !describe_begin(self) ){ return; }
+        To* t = to_alloc(self);
+        if(t == NULL){
+            printf("ERROR: not enough To slots left\n");
+            Caw_printf("ERROR: not enough To slots left\n");
+            return;
+        }
+        seq_append(self, t);
+        t->ctrl = ToLiteral;
+        t->a.type = ElemT_Float;
+        t->b.type = ElemT_Float;
+        t->c.type = ElemT_Shape;
+        self->direct = t - tos;
+        self->optimized = 0;
+    } else {
+        S_queue_clear(index);
+    }
+    To* t = &tos[self->direct];
+    t->a.obj.f     = volts;
+    t->b.obj.f     = seconds;
+    t->c.obj.shape = shape;
+    casl_action(index, 1);
+}
+
+int casl_optimized( int index )
+{
+    if(index < 0 || index >= SELVES_COUNT){ return 0; }
+    return _selves[index]->optimized;
 }
 
 // suite of functions for unwrapping elements of Lua tables
@@ -142,10 +369,9 @@ static int ix_int( lua_State* L, int ix )
 
 static To* to_alloc( Casl* self )
 {
-    if(self->to_ix >= TO_COUNT){ return NULL; }
-    To* t = &self->tos[self->to_ix]; // get next To
-    self->to_ix++; // mark as allocated
-    return t;
+    int ix = pool_alloc(CaslPool_To, self->index);
+    if(ix < 0){ return NULL; }
+    return &tos[ix];
 }
 
 static void read_to( Casl* self, To* t, lua_State* L );
@@ -183,9 +409,18 @@ static void parse_table( Casl* self, lua_State* L )
 
         case LUA_TTABLE:{ // NEST
             To* t = to_alloc(self);
+            if(t == NULL){
+                printf("ERROR: not enough To slots left\n");
+                Caw_printf("ERROR: not enough To slots left\n");
+                return;
+            }
             seq_append(self, t);
             t->ctrl = ToEnter; // mark as entering a sub-Seq
-            seq_enter(self);
+            if( !seq_enter(self) ){ // skip the nest: an always-true If is a no-op
+                t->ctrl = ToIf;
+                t->a = (Elem){ .obj.f = 1.0, .type = ElemT_Float };
+                return;
+            }
             t->a.obj.seq = self->seq_select; // pass this To* to seq_enter, and do this line in there
             int seq_len = lua_rawlen(L, -1);
             for( int i=1; i<=seq_len; i++ ){ // Lua is 1-based
@@ -216,12 +451,78 @@ static void allocating_capture( Casl* self, Elem* e, lua_State* L, ElemT t, int
 {
     e->type = t;
     for(int i=0; i<count; i++){
-        int var = casl_defdynamicP(self); // allocate a dynamic to hold op. FIXME 0 is asl id
+        int var = casl_defdynamicP(self); // allocate a dynamic to hold op
+        if(var < 0){ return; }
         e->obj.var[i] = var; // capture dynamic ref
-        capture_elem(self, &self->dynamics[var], L, i+2); // recur to capture operand
+        capture_elem(self, &dynamics[var], L, i+2); // recur to capture operand
     }
 }
 
+// 0-based, wrapping in both directions like sequins.lua's wrap_index
+static int seqn_wrap( int ix, int len )
+{
+    ix %= len;
+    return (ix < 0) ? ix + len : ix;
+}
+
+// ix & set_ix are lua's 1-based sequins fields. set_ix of 0 is nil
+static void seqn_init( Elem* s, int len, int ix, int set_ix )
+{
+    s[SEQN_LENGTH] = (Elem){ .obj.dyn = len, .type = ElemT_Float };
+    s[SEQN_INDEX]  = (Elem){ .obj.dyn = seqn_wrap(ix - 1, len), .type = ElemT_Float };
+    s[SEQN_SELECT] = (Elem){ .obj.dyn = set_ix ? seqn_wrap(set_ix - 1, len) : -1
+                           , .type = ElemT_Float };
+}
+
+// {'SEQN', step, ix, set_ix, values...}
+static void capture_sequins( Casl* self, Elem* e, lua_State* L )
+{
+    int len = lua_rawlen(L, -1) - SEQN_VALUES;
+    int base = (len > 0) ? pool_alloc_run(CaslPool_Dyn, self->index, SEQN_VALUES + len) : -1;
+    if(base < 0){
+        printf("ERROR: no dynamic slots for sequins\n");
+        Caw_printf("ERROR: no dynamic slots for sequins\n");
+        e->obj.f = 0.0;
+        e->type  = ElemT_Float;
+        return;
+    }
+    seqn_init( &dynamics[base], len, ix_int(L, 3), ix_int(L, 4) );
+    capture_elem(self, &dynamics[base+SEQN_STEP], L, 2);
+    for(int i=0; i<len; i++){
+        capture_elem(self, &dynamics[base+SEQN_VALUES+i], L, i+SEQN_VALUES+1);
+    }
+    e->obj.var[0] = base;
+    e->type = ElemT_Sequins;
+}
+
+// {'HOLD', source, period}
+static void capture_hold( Casl* self, Elem* e, lua_State* L )
+{
+    int base = pool_alloc_run(CaslPool_Dyn, self->index, SAH_SIZE);
+    if(base < 0){
+        printf("ERROR: no dynamic slots for sample & hold\n");
+        Caw_printf("ERROR: no dynamic slots for sample & hold\n");
+        e->obj.f = 0.0;
+        e->type  = ElemT_Float;
+        return;
+    }
+    capture_elem(self, &dynamics[base+SAH_SOURCE], L, 2);
+    capture_elem(self, &dynamics[base+SAH_PERIOD], L, 3);
+    dynamics[base+SAH_COUNT] = (Elem){ .obj.dyn = 0, .type = ElemT_Float }; // sample on first use
+    dynamics[base+SAH_VALUE] = (Elem){ .obj.f = 0.0, .type = ElemT_Float };
+    e->obj.var[0] = base;
+    e->type = ElemT_SampleHold;
+}
+
+// a description referred to a dynamic it doesn't hold. e becomes 0.0
+static void stale_dynamic( Elem* e )
+{
+    printf("ERROR: stale dynamic in ASL\n");
+    Caw_printf("ERROR: stale dynamic in ASL\n");
+    e->obj.f = 0.0;
+    e->type = ElemT_Float;
+}
+
 // REFACTOR to have it return the Elem (and copy it) rather than passing a pointer
 static void capture_elem( Casl* self, Elem* e, lua_State* L, int ix )
 {
@@ -248,13 +549,17 @@ static void capture_elem( Casl* self, Elem* e, lua_State* L, int ix )
             char index = ix_char(L, 1); // parse on first char at ix[1]
             switch( index ){ // parse on first char at ix[1]
                 case 'D':{ // DYNAMIC
-                    e->obj.dyn = ix_int(L, 2); // grab dyn_ix at ix[2]
+                    int dyn = dyn_slot(self->index, ix_int(L, 2)); // grab dyn handle at ix[2]
+                    if(dyn < 0){ stale_dynamic(e); break; }
+                    e->obj.dyn = dyn;
                     e->type = ElemT_Dynamic;
                     break;}
                 case 'M': // MUTABLE
                     allocating_capture(self, e, L, ElemT_Mutable, 1); break;
                 case 'N':{// NAMED MUTABLE. combination of dynamic & mutable for live update
-                    e->obj.var[0] = ix_int(L, 2); // grab dyn_ix at ix[2]
+                    int dyn = dyn_slot(self->index, ix_int(L, 2)); // grab dyn handle at ix[2]
+                    if(dyn < 0){ stale_dynamic(e); break; }
+                    e->obj.var[0] = dyn;
                     e->type = ElemT_Mutable;
                     break;}
                 case '~': allocating_capture(self, e, L, ElemT_Negate, 1); break;
@@ -264,6 +569,12 @@ static void capture_elem( Casl* self, Elem* e, lua_State* L, int ix )
                 case '/': allocating_capture(self, e, L, ElemT_Div, 2); break;
                 case '%': allocating_capture(self, e, L, ElemT_Mod, 2); break;
                 case '#': allocating_capture(self, e, L, ElemT_Mutate, 1); break;
+                case 'S': capture_sequins(self, e, L); break;
+                case 'R': // RAND. no operands for [0,1), else a range
+                    if( lua_rawlen(L, -1) < 3 ){ e->type = ElemT_Random; }
+                    else { allocating_capture(self, e, L, ElemT_RandRange, 2); }
+                    break;
+                case 'H': capture_hold(self, e, L); break;
 
                 default:
                     printf("ERROR composite To char '%c'not found\n",index);
@@ -281,6 +592,189 @@ static void capture_elem( Casl* self, Elem* e, lua_State* L, int ix )
 }
 
 
+///////////////////////////////
+// binary parser
+// same node construction as parse_table, in one linear pass over the buffer
+
+static uint8_t rd_u8( Reader* r )
+{
+    if( r->p >= r->end ){ r->err = true; return 0; }
+    return *r->p++;
+}
+
+static void rd_bytes( Reader* r, void* dst, int count )
+{
+    if( r->end - r->p < count ){
+        r->err = true;
+        memset(dst, 0, count);
+        return;
+    }
+    memcpy(dst, r->p, count); // unaligned
+    r->p += count;
+}
+
+static uint16_t rd_u16( Reader* r ){ uint16_t v; rd_bytes(r, &v, 2); return v; }
+static int16_t  rd_i16( Reader* r ){ int16_t v;  rd_bytes(r, &v, 2); return v; }
+static float    rd_f(   Reader* r ){ float v;    rd_bytes(r, &v, 4); return v; }
+
+static void bin_elem( Casl* self, Elem* e, Reader* r );
+
+static void bin_operands( Casl* self, Elem* e, Reader* r, ElemT t, int count )
+{
+    e->type = t;
+    for(int i=0; i<count; i++){
+        int var = casl_defdynamicP(self);
+        if(var < 0){ r->err = true; return; } // operand can't be skipped
+        e->obj.var[i] = var;
+        bin_elem(self, &dynamics[var], r);
+    }
+}
+
+static void bin_sequins( Casl* self, Elem* e, Reader* r )
+{
+    int len    = rd_u16(r);
+    int ix     = rd_i16(r);
+    int set_ix = rd_i16(r);
+    int base = (len > 0) ? pool_alloc_run(CaslPool_Dyn, self->index, SEQN_VALUES + len) : -1;
+    if(base < 0){
+        printf("ERROR: no dynamic slots for sequins\n");
+        Caw_printf("ERROR: no dynamic slots for sequins\n");
+        r->err = true;
+        return;
+    }
+    seqn_init( &dynamics[base], len, ix, set_ix );
+    bin_elem(self, &dynamics[base+SEQN_STEP], r);
+    for(int i=0; i<len; i++){
+        bin_elem(self, &dynamics[base+SEQN_VALUES+i], r);
+    }
+    e->obj.var[0] = base;
+    e->type = ElemT_Sequins;
+}
+
+static void bin_hold( Casl* self, Elem* e, Reader* r )
+{
+    int base = pool_alloc_run(CaslPool_Dyn, self->index, SAH_SIZE);
+    if(base < 0){
+        printf("ERROR: no dynamic slots for sample & hold\n");
+        Caw_printf("ERROR: no dynamic slots for sample & hold\n");
+        r->err = true;
+        return;
+    }
+    bin_elem(self, &dynamics[base+SAH_SOURCE], r);
+    bin_elem(self, &dynamics[base+SAH_PERIOD], r);
+    dynamics[base+SAH_COUNT] = (Elem){ .obj.dyn = 0, .type = ElemT_Float }; // sample on first use
+    dynamics[base+SAH_VALUE] = (Elem){ .obj.f = 0.0, .type = ElemT_Float };
+    e->obj.var[0] = base;
+    e->type = ElemT_SampleHold;
+}
+
+static void bin_elem( Casl* self, Elem* e, Reader* r )
+{
+    *e = (Elem){ .obj.f = 0.0, .type = ElemT_Float }; // safe value if parsing fails
+    if( r->err ){ return; }
+    char tag = rd_u8(r);
+    switch( tag ){
+        case 'f':{
+            e->obj.f = rd_f(r);
+            e->type = ElemT_Float;
+            break;}
+        case 's':{
+            char name[3];
+            name[0] = rd_u8(r);
+            name[1] = rd_u8(r);
+            name[2] = '\0';
+            e->obj.shape = S_str_to_shape(name);
+            e->type = ElemT_Shape;
+            break;}
+        case 'D':{
+            int dyn = dyn_slot(self->index, rd_u16(r));
+            if(dyn < 0){ stale_dynamic(e); r->err = true; break; }
+            e->obj.dyn = dyn;
+            e->type = ElemT_Dynamic;
+            break;}
+        case 'N':{
+            int dyn = dyn_slot(self->index, rd_u16(r));
+            if(dyn < 0){ stale_dynamic(e); r->err = true; break; }
+            e->obj.var[0] = dyn;
+            e->type = ElemT_Mutable;
+            break;}
+        case 'M': bin_operands(self, e, r, ElemT_Mutable, 1); break;
+        case '~': bin_operands(self, e, r, ElemT_Negate, 1); break;
+        case '+': bin_operands(self, e, r, ElemT_Add, 2); break;
+        case '-': bin_operands(self, e, r, ElemT_Sub, 2); break;
+        case '*': bin_operands(self, e, r, ElemT_Mul, 2); break;
+        case '/': bin_operands(self, e, r, ElemT_Div, 2); break;
+        case '%': bin_operands(self, e, r, ElemT_Mod, 2); break;
+        case '#': bin_operands(self, e, r, ElemT_Mutate, 1); break;
+        case 'r': e->type = ElemT_Random; break;
+        case 'R': bin_operands(self, e, r, ElemT_RandRange, 2); break;
+        case 'S': bin_sequins(self, e, r); break;
+        case 'H': bin_hold(self, e, r); break;
+        default:
+            if( r->err ){ break; } // ran out of data
+            printf("ERROR composite To char '%c'not found\n",tag);
+            Caw_printf("ERROR ASL unhandled type. Do you have a function in your ASL? Replace it with dyn.\n");
+            r->err = true;
+            break;
+    }
+}
+
+static void bin_stage( Casl* self, Reader* r )
+{
+    if( r->err ){ return; }
+    char tag = rd_u8(r);
+    if( r->err ){ return; }
+    To* t = to_alloc(self);
+    if(t == NULL){
+        printf("ERROR: not enough To slots left\n");
+        Caw_printf("ERROR: not enough To slots left\n");
+        r->err = true; // remaining stages can't be skipped safely
+        return;
+    }
+    seq_append(self, t);
+    switch( tag ){
+        case 'T':
+            bin_elem(self, &(t->a), r);
+            bin_elem(self, &(t->b), r);
+            bin_elem(self, &(t->c), r);
+            t->ctrl = ToLiteral;
+            break;
+        case 'R': t->ctrl = ToRecur; break;
+        case 'I':
+            bin_elem(self, &(t->a), r);
+            t->ctrl = ToIf;
+            break;
+        case 'H': t->ctrl = ToHeld; break;
+        case 'W': t->ctrl = ToWait; break;
+        case 'U': t->ctrl = ToUnheld; break;
+        case 'L': t->ctrl = ToLock; break;
+        case 'O': t->ctrl = ToOpen; break;
+        case '[':
+            t->ctrl = ToEnter;
+            if( !seq_enter(self) ){
+                t->ctrl = ToIf; // always-true If is a no-op
+                t->a = (Elem){ .obj.f = 1.0, .type = ElemT_Float };
+                r->err = true;
+                return;
+            }
+            t->a.obj.seq = self->seq_select;
+            while( !r->err ){
+                if( r->p < r->end && *r->p == ']' ){ r->p++; break; }
+                bin_stage(self, r); // RECUR
+            }
+            seq_exit(self);
+            break;
+        default:
+            printf("ERROR char not found\n");
+            Caw_printf("ERROR char not found\n");
+            t->ctrl = ToIf; // keep the appended node harmless
+            t->a = (Elem){ .obj.f = 1.0, .type = ElemT_Float };
+            r->err = true;
+            break;
+    }
+}
+
+
 ///////////////////////////////
 // Runtime
 
@@ -288,9 +782,9 @@ static To* seq_advance( Casl* self )
 {
     Sequence* s = self->seq_current;
     To* t = NULL;
-    if( s->pc < s->length ){ // stages remain
-        t = s->stage[s->pc]; // get next stage
-        s->pc++; // select following stage
+    if( s->pc != CASL_NIL ){ // stages remain
+        t = &tos[s->pc]; // get next stage
+        s->pc = t->next; // select following stage
     }
     return t;
 }
@@ -300,58 +794,104 @@ static bool seq_up( Casl* self )
 {
     if( self->seq_current->parent < 0 ){ return false; } // nothing left to do
 
-    self->seq_current->pc = 0; // RESET PC so it runs more than once
+    self->seq_current->pc = self->seq_current->head; // RESET PC so it runs more than once
     // TODO this will prob change when it comes to nesting conditionals?
     // TODO or at least when it comes to behavioural data
 
     self->seq_select = self->seq_current->parent;
-    self->seq_current = &self->seqs[self->seq_select];
+    self->seq_current = &seqs[self->seq_select];
     return true;
 }
 
 static void seq_down( Casl* self, int s_ix )
 {
     self->seq_select = s_ix;
-    self->seq_current = &self->seqs[self->seq_select];
+    self->seq_current = &seqs[self->seq_select];
 }
 
 static void next_action( int index );
 static bool find_control( Casl* self, ToControl ctrl, bool full_search );
 static ElemO resolve( Casl* self, Elem* e );
 
-void casl_action( int index, int action )
+static void run_action( Casl* self );
+
+// outcome of the hand-off, reported once IRQs are enabled again
+typedef enum{ Act_None
+            , Act_Run
+            , Act_Restart // no release stage was found
+            , Act_Ignored
+} ActStart;
+
+static void restart( Casl* self )
 {
-    if(index < 0 || index >= SELVES_COUNT){ return; }
-    Casl* self = _selves[index];
+    self->seq_select = self->seq_root;
+    self->seq_current = &seqs[self->seq_root]; // first sequence
+    seq_reset_all(self); // reset all program counters
+    self->holding = false;
+    self->locked = false;
+}
 
+// takes the sequence over from the ISR. call with IRQs blocked
+static ActStart begin_action( Casl* self, int action )
+{
     if( self->locked ){ // can't apply action until unlocked
         if( action == 2 ){ self->locked = false; } // 'unlock' message received
-        return; // doesn't trigger action
+        return Act_None; // doesn't trigger action
     }
+    if( self->seq_root < 0 ){ return Act_None; } // nothing described
+
+    rewind_prefetch(self); // act from the playing stage, not the queued ones
+
+    ActStart start = Act_Run;
     if( action == 1){ // restart sequence
-        self->seq_current = &self->seqs[0]; // first sequence
-        for(int i=0; i<SEQ_COUNT; i++){ self->seqs[i].pc = 0; } // reset all program counters
-        self->holding = false;
-        self->locked = false;
+        restart(self);
     } else if( action == 0 && self->holding ){ // goto release if held
         if( find_control(self, ToUnheld, false) ){
             self->holding = false;
         } else {
-            printf("couldn't find ToWait. restarting\n");
-            casl_action(index, 1);
-            return;
+            restart(self);
+            start = Act_Restart;
         }
     } else {
-        printf("do nothing\n");
-        return;
+        return Act_Ignored;
     }
-    next_action(index);
+    S_queue_clear(self->index); // discard segments resolved from the old position
+    self->acting = true; // breakpoints now leave the sequence to us
+    return start;
 }
 
+void casl_action( int index, int action )
+{
+    if(index < 0 || index >= SELVES_COUNT){ return; }
+    Casl* self = _selves[index];
+
+    ActStart start;
+    BLOCK_IRQS( // breakpoints in the audio ISR run next_action on the same state
+        start = begin_action(self, action);
+    );
+    switch( start ){
+        case Act_Restart: printf("couldn't find ToWait. restarting\n"); break;
+        case Act_Ignored: printf("do nothing\n"); return;
+        case Act_None: return;
+        default: break;
+    }
+    run_action(self); // resolving & event posting run with IRQs enabled
+}
+
+// slope breakpoint, in the audio ISR
 static void next_action( int index )
 {
     if(index < 0 || index >= SELVES_COUNT){ return; }
     Casl* self = _selves[index];
+    if( self->acting ){ return; } // casl_action is restarting this channel
+    run_action(self);
+}
+
+static void run_action( Casl* self )
+{
+    int index = self->index;
+    if(self->seq_current == NULL){ self->acting = false; return; } // nothing described
+    self->ahead = 0; // the queue is empty, so pc is at playback
 
     while(true){ // repeat until halt
         To* t = seq_advance(self);
@@ -359,13 +899,18 @@ static void next_action( int index )
             switch(t->ctrl){
                 case ToLiteral:{
                     float ms = resolve(self, &t->b).f * 1000.0;
-                    S_toward( index
-                            , resolve(self, &t->a).f
-                            , ms
-                            , resolve(self, &t->c).shape
-                            , &next_action // recur upon breakpoint
-                            );
-                    if(ms > 0.0){ return; } // wait for DSP callback before proceeding
+                    float dest = resolve(self, &t->a).f;
+                    Shape_t shape = resolve(self, &t->c).shape;
+                    BLOCK_IRQS( // a timed segment hands the sequence back to its breakpoint
+                        S_toward( index, dest, ms, shape
+                                , &next_action // recur upon breakpoint
+                                );
+                        if(ms > 0.0){ self->acting = false; }
+                    );
+                    if(ms > 0.0){ // wait for DSP callback before proceeding
+                        request_prefetch(index); // resolve what follows outside the ISR
+                        return;
+                    }
                     break;}
 
                 case ToIf:{
@@ -374,10 +919,10 @@ static void next_action( int index )
                     }
                     break;}
 
-                case ToRecur:{  self->seq_current->pc = 0;    break;}
+                case ToRecur:{  self->seq_current->pc = self->seq_current->head; break;}
                 case ToEnter:   seq_down(self, t->a.obj.seq); break;
                 case ToHeld:{   self->holding = true;         break;}
-                case ToWait:    /* halt execution */    return;
+                case ToWait:    self->acting = false; return; // halt execution
                 case ToUnheld:{ self->holding = false;        break;} // this is never executed, but here for reference
                 case ToLock:{   self->locked = true;          break;}
                 case ToOpen:{   self->locked = false;         break;}
@@ -385,6 +930,7 @@ static void next_action( int index )
         } else {
 stepup:
             if( !seq_up(self) ){ // To invalid. Jump up. return if nothing left to do
+                self->acting = false;
                 L_queue_asl_done(index); // trigger a lua event when sequence is complete
                 return;
             }
@@ -392,6 +938,138 @@ stepup:
     }
 }
 
+///////////////////////////////
+// Prefetch
+// resolves upcoming segments into the slope's queue from the event loop,
+// so breakpoints in the audio ISR only pop a precomputed segment.
+// only stages of the current sequence whose values can't change before they
+// play are queued: literals, dynamics & pure arithmetic. everything else,
+// including navigation out of the sequence, is left for next_action at the
+// breakpoint, preserving its timing.
+// the sequence pc runs ahead of playback by the queued stages. 'played' marks
+// where they began, so an action or a changed dynamic can rewind to playback.
+
+static void handle_prefetch( event_t* e );
+
+static void request_prefetch( int index )
+{
+    if(index < 0 || index >= SELVES_COUNT){ return; }
+    Casl* self = _selves[index];
+
+    if( self->prefetching ){ return; } // already queued
+    self->prefetching = true;
+    event_t e = { .handler = handle_prefetch
+                , .index.i = index
+                };
+    if( !event_post(&e) ){ self->prefetching = false; }
+}
+
+// true if resolving e has no side effects & reads nothing that can change
+static bool prefetchable( Elem* e )
+{
+    switch( e->type ){
+        case ElemT_Float:
+        case ElemT_Shape: return true;
+        case ElemT_Dynamic: return prefetchable( &dynamics[e->obj.dyn] ); // rewound on change
+        case ElemT_Negate: return prefetchable( &dynamics[e->obj.var[0]] );
+        case ElemT_Add:
+        case ElemT_Sub:
+        case ElemT_Mul:
+        case ElemT_Div:
+        case ElemT_Mod: return prefetchable( &dynamics[e->obj.var[0]] )
+                            && prefetchable( &dynamics[e->obj.var[1]] );
+        case ElemT_Program:
+            for( const CaslOp* op = &code[e->obj.dyn]; op->op != OpEnd; op++ ){
+                switch( op->op ){ // as the tree cases: no mutation & no random draws
+                    case OpMutable: case OpMutate:
+                    case OpRandom: case OpRange: return false;
+                    default: break;
+                }
+            }
+            return true;
+        default: return false; // mutables, sequins, sample & hold, random
+    }
+}
+
+// the stage following n queued stages from pc. mirrors prefetch_step
+static uint16_t skip_queued( Sequence* s, uint16_t pc, int n )
+{
+    while( n > 0 && pc != CASL_NIL ){
+        To* t = &tos[pc];
+        if( t->ctrl == ToRecur ){
+            pc = s->head;
+        } else {
+            pc = t->next;
+            n--; // only literals are queued
+        }
+    }
+    return pc;
+}
+
+// move 'played' past the stages the ISR has popped. call with IRQs blocked
+static void played_sync( Casl* self )
+{
+    int queued = SLOPE_QUEUE_LEN - S_queue_space(self->index);
+    self->played = skip_queued( self->seq_current, self->played, self->ahead - queued );
+    self->ahead  = queued;
+}
+
+// discard queued stages & return the pc to playback. call with IRQs blocked
+static void rewind_prefetch( Casl* self )
+{
+    if( self->ahead == 0 ){ return; } // pc is already at playback
+    played_sync(self);
+    self->seq_current->pc = self->played;
+    self->ahead = 0;
+    S_queue_clear(self->index);
+}
+
+// returns false when prefetching must stop
+static bool prefetch_step( Casl* self, int index )
+{
+    Sequence* s = self->seq_current;
+    if( s->pc == CASL_NIL ){ return false; } // leaving the sequence is left to next_action
+    To* t = &tos[s->pc];
+    switch( t->ctrl ){
+        case ToLiteral:{
+            if( !prefetchable(&t->a) || !prefetchable(&t->b) || !prefetchable(&t->c) ){
+                return false; // resolved when it plays
+            }
+            float ms = resolve(self, &t->b).f * 1000.0; // same order as next_action
+            float dest = resolve(self, &t->a).f;
+            if( !S_queue_push( index, dest, ms, resolve(self, &t->c).shape ) ){
+                return false;
+            }
+            s->pc = t->next;
+            self->ahead++;
+            return true;}
+        case ToRecur:
+            if( s->head == s->pc ){ return false; } // empty loop
+            s->pc = s->head;
+            return true;
+        default: return false;
+    }
+}
+
+static void handle_prefetch( event_t* e )
+{
+    int index = e->index.i;
+    Casl* self = _selves[index];
+
+    self->prefetching = false;
+    if( self->seq_current == NULL ){ return; } // nothing described
+    while( S_queue_space(index) > 0
+        && S_queue_lead(index) < CASL_PREFETCH_MS ){
+        bool more;
+        BLOCK_IRQS( // the ISR may fall back to next_action on an empty queue
+            played_sync(self);
+            if( self->ahead == 0 ){ self->played = self->seq_current->pc; }
+            more = prefetch_step(self, index);
+        );
+        if( !more ){ return; }
+    }
+}
+
 static bool find_control( Casl* self, ToControl ctrl, bool full_search )
 {
     To* t = seq_advance(self);
@@ -414,15 +1092,16 @@ static bool find_control( Casl* self, ToControl ctrl, bool full_search )
 }
 
 // resolves behavioural types to a literal value
-static volatile uint16_t resolving_mutable; // tmp global var for cheaper recursive fn
-#define RESOLVE_VAR(self, e, n) _resolve(self, &self->dynamics[e->obj.var[n]] ).f
-static ElemO _resolve( Casl* self, Elem* e )
+// mutable is the dynamic awaiting a mutation. it's per call, as the audio ISR
+// & the main loop both resolve
+#define RESOLVE_VAR(self, e, n) _resolve(self, &dynamics[e->obj.var[n]], mutable ).f
+static ElemO _resolve( Casl* self, Elem* e, uint16_t* mutable )
 {
     switch( e->type ){
-        case ElemT_Dynamic: return _resolve(self, &self->dynamics[e->obj.dyn] );
+        case ElemT_Dynamic: return _resolve(self, &dynamics[e->obj.dyn], mutable );
         case ElemT_Mutable:{
-            resolving_mutable = e->obj.var[0];
-            return _resolve(self, &self->dynamics[e->obj.var[0]] );}
+            *mutable = e->obj.var[0];
+            return _resolve(self, &dynamics[e->obj.var[0]], mutable );}
         case ElemT_Negate: return (ElemO){-RESOLVE_VAR(self,e,0)};
         case ElemT_Add: return (ElemO){RESOLVE_VAR(self,e,0) + RESOLVE_VAR(self,e,1)};
         case ElemT_Sub: return (ElemO){RESOLVE_VAR(self,e,0) - RESOLVE_VAR(self,e,1)};
@@ -437,73 +1116,444 @@ static ElemO _resolve( Casl* self, Elem* e )
             return (ElemO){val - (wrap * mul)};} // -0.001 - (0.1 * -1) => 0.099
         case ElemT_Mutate:{
             ElemO mutated = (ElemO){RESOLVE_VAR(self,e,0)};
-            if(resolving_mutable < DYN_COUNT){
-                self->dynamics[resolving_mutable].obj = mutated; // update value
-                resolving_mutable = DYN_COUNT; // mutation resolved!
+            if(*mutable < DYN_COUNT){
+                dynamics[*mutable].obj = mutated; // update value
+                *mutable = DYN_COUNT; // mutation resolved!
             }
             return mutated;} // return the resultant value
+        case ElemT_Sequins:{ // step the index (or take the selection), then return its value
+            Elem* s = &dynamics[e->obj.var[0]];
+            int ix = s[SEQN_SELECT].obj.dyn;
+            if( ix < 0 ){
+                ix = s[SEQN_INDEX].obj.dyn + (int)_resolve(self, &s[SEQN_STEP], mutable).f;
+            }
+            ix = seqn_wrap( ix, s[SEQN_LENGTH].obj.dyn );
+            s[SEQN_SELECT].obj.dyn = -1;
+            s[SEQN_INDEX].obj.dyn  = ix;
+            return _resolve(self, &s[SEQN_VALUES + ix], mutable);}
+        case ElemT_Random: return (ElemO){Random_Float()};
+        case ElemT_RandRange:{
+            float min = RESOLVE_VAR(self,e,0);
+            float max = RESOLVE_VAR(self,e,1);
+            return (ElemO){min + Random_Float() * (max - min)};}
+        case ElemT_SampleHold:{
+            Elem* h = &dynamics[e->obj.var[0]];
+            if( --h[SAH_COUNT].obj.dyn < 0 ){ // take a new sample
+                h[SAH_VALUE].obj = _resolve(self, &h[SAH_SOURCE], mutable);
+                int period = (int)_resolve(self, &h[SAH_PERIOD], mutable).f;
+                h[SAH_COUNT].obj.dyn = (period > 1) ? period - 1 : 0;
+            }
+            return h[SAH_VALUE].obj;}
         default: return e->obj;
     }
 }
 #undef RESOLVE_VAR
 
+static float run( const CaslOp* pc );
+
 // wrap _resolve with mutable resolution
 static ElemO resolve( Casl* self, Elem* e )
 {
-    resolving_mutable = DYN_COUNT; // out of range
-    ElemO eo = _resolve(self, e);
-    if(resolving_mutable < DYN_COUNT){
-        self->dynamics[resolving_mutable].obj = eo; // update value
+    if( e->type == ElemT_Program ){ return (ElemO){ .f = run(&code[e->obj.dyn]) }; }
+
+    uint16_t mutable = DYN_COUNT; // out of range
+    ElemO eo = _resolve(self, e, &mutable);
+    if(mutable < DYN_COUNT){
+        dynamics[mutable].obj = eo; // update value
     }
     return eo;
 }
 
+////////////////////////////////////
+// Optimizer
+// runs after parsing, returning unused nodes to the pools:
+// folds constant arithmetic into literals, removes Ifs with a literal
+// predicate (& everything after a false one), and inlines Sequences that
+// are empty or hold a single To. returns the number of nodes saved
+
+static int operand_count( Elem* e )
+{
+    switch( e->type ){
+        case ElemT_Negate: case ElemT_Mutable: case ElemT_Mutate: return 1;
+        case ElemT_Add: case ElemT_Sub: case ElemT_Mul: case ElemT_Div: case ElemT_Mod:
+        case ElemT_RandRange: return 2;
+        default: return 0;
+    }
+}
+
+// literal arithmetic only. dynamics & mutables may change at runtime
+static bool is_constant( Elem* e )
+{
+    switch( e->type ){
+        case ElemT_Float: return true;
+        case ElemT_Negate: case ElemT_Add: case ElemT_Sub:
+        case ElemT_Mul: case ElemT_Div: case ElemT_Mod:
+            for( int i=0; i<operand_count(e); i++ ){
+                if( !is_constant(&dynamics[e->obj.var[i]]) ){ return false; }
+            }
+            return true;
+        default: return false;
+    }
+}
+
+// operands of a constant are always temporaries from allocating_capture
+static int free_operands( Elem* e )
+{
+    int n = 0;
+    for( int i=0; i<operand_count(e); i++ ){
+        uint16_t ix = e->obj.var[i];
+        n += free_operands(&dynamics[ix]);
+        pool_free(CaslPool_Dyn, ix);
+        n++;
+    }
+    return n;
+}
+
+static int fold( Casl* self, Elem* e )
+{
+    if( e->type == ElemT_Float ){ return 0; }
+    if( is_constant(e) ){
+        uint16_t mutable = DYN_COUNT; // constants hold no mutables
+        float f = _resolve(self, e, &mutable).f;
+        int n = free_operands(e);
+        e->obj.f = f;
+        e->type  = ElemT_Float;
+        return n;
+    }
+    if( e->type == ElemT_Mutable ){ return 0; } // operand is the mutable's storage
+    int n = 0;
+    for( int i=0; i<operand_count(e); i++ ){
+        n += fold(self, &dynamics[e->obj.var[i]]);
+    }
+    return n;
+}
+
+static int free_seq( int s_ix );
+
+static int free_to( uint16_t ix )
+{
+    int n = 0;
+    if( tos[ix].ctrl == ToEnter ){ n += free_seq(tos[ix].a.obj.seq); }
+    pool_free(CaslPool_To, ix);
+    return n + 1;
+}
+
+static int free_seq( int s_ix )
+{
+    int n = 0;
+    uint16_t ix = seqs[s_ix].head;
+    while( ix != CASL_NIL ){
+        uint16_t next = tos[ix].next;
+        n += free_to(ix);
+        ix = next;
+    }
+    pool_free(CaslPool_Seq, s_ix);
+    return n + 1;
+}
+
+static int prune_ifs( Sequence* s )
+{
+    int n = 0;
+    uint16_t* link = &s->head;
+    uint16_t last = CASL_NIL;
+    while( *link != CASL_NIL ){
+        uint16_t ix = *link;
+        To* t = &tos[ix];
+        if( t->ctrl == ToIf && t->a.type == ElemT_Float ){
+            if( !(t->a.obj.f <= 0.0) ){ // always true: If is a no-op
+                *link = t->next;
+                n += free_to(ix);
+                s->length--;
+                continue;
+            }
+            // always false: jumps up, same as reaching the end of this Sequence
+            *link = CASL_NIL;
+            while( ix != CASL_NIL ){
+                uint16_t next = tos[ix].next;
+                n += free_to(ix);
+                s->length--;
+                ix = next;
+            }
+            break;
+        }
+        last = ix;
+        link = &t->next;
+    }
+    s->tail = last;
+    return n;
+}
+
+static int flatten( Sequence* s )
+{
+    int n = 0;
+    uint16_t* link = &s->head;
+    uint16_t last = CASL_NIL;
+    while( *link != CASL_NIL ){
+        uint16_t ix = *link;
+        To* t = &tos[ix];
+        if( t->ctrl == ToEnter ){
+            int sub_ix = t->a.obj.seq;
+            Sequence* sub = &seqs[sub_ix];
+            if( sub->length == 0 ){ // entering does nothing
+                *link = t->next;
+                n += free_to(ix);
+                s->length--;
+                continue;
+            } else if( sub->length == 1 && tos[sub->head].ctrl == ToLiteral ){
+                uint16_t next = t->next;
+                uint16_t inner = sub->head;
+                *t = tos[inner]; // pull the To up in place of the Enter
+                t->next = next;
+                pool_free(CaslPool_To, inner);
+                pool_free(CaslPool_Seq, sub_ix);
+                n += 2;
+            }
+        }
+        last = ix;
+        link = &t->next;
+    }
+    s->tail = last;
+    return n;
+}
+
+static int optimize( Casl* self )
+{
+    int n = 0;
+    for( int i=0; i<TO_COUNT; i++ ){
+        if( to_owner[i] != self->index ){ continue; }
+        To* t = &tos[i];
+        switch( t->ctrl ){
+            case ToLiteral:
+                n += fold(self, &t->a);
+                n += fold(self, &t->b); // c is a shape
+                break;
+            case ToIf: n += fold(self, &t->a); break;
+            default: break;
+        }
+    }
+    for( int i=0; i<SEQ_COUNT; i++ ){
+        if( seq_owner[i] == self->index ){ n += prune_ifs(&seqs[i]); }
+    }
+    int saved;
+    do{ // repeat as inlining can leave a parent with a single stage
+        saved = 0;
+        for( int i=0; i<SEQ_COUNT; i++ ){
+            if( seq_owner[i] == self->index ){ saved += flatten(&seqs[i]); }
+        }
+        n += saved;
+    } while( saved );
+
+    self->seq_select  = self->seq_root;
+    self->seq_current = &seqs[self->seq_root];
+    seq_reset_all(self);
+    return n;
+}
+
+////////////////////////////////////
+// Bytecode
+// element trees are compiled at describe time into postfix programs
+// which evaluate in a loop over a small stack, rather than recursing the tree.
+// elements that can't compile (pool exhausted, too deep) fall back to _resolve
+
+#define PROGRAM_MAX 64 // ops in a single element
+
+typedef struct{
+    CaslOp ops[PROGRAM_MAX];
+    int    len;
+    int    depth; // current stack depth
+    int    max;   // peak stack depth
+} Compiler;
+
+static bool emit( Compiler* c, CaslOpcode op, int stack_change )
+{
+    if( c->len >= PROGRAM_MAX ){ return false; }
+    c->ops[c->len].op = op;
+    c->ops[c->len].arg.ix = 0;
+    c->len++;
+    c->depth += stack_change;
+    if( c->depth > c->max ){ c->max = c->depth; }
+    return true;
+}
+
+static bool compile_elem( Compiler* c, Elem* e );
+
+// dynamics holding a Float are read at runtime, as Lua or a mutation may change them
+static bool compile_dyn( Compiler* c, uint16_t ix )
+{
+    if( ix >= DYN_COUNT ){ return false; }
+    if( dynamics[ix].type != ElemT_Float ){ return compile_elem(c, &dynamics[ix]); }
+    if( !emit(c, OpLoad, 1) ){ return false; }
+    c->ops[c->len-1].arg.ix = ix;
+    return true;
+}
+
+static bool compile_binary( Compiler* c, Elem* e, CaslOpcode op )
+{
+    return compile_dyn(c, e->obj.var[0])
+        && compile_dyn(c, e->obj.var[1])
+        && emit(c, op, -1);
+}
+
+static bool compile_elem( Compiler* c, Elem* e )
+{
+    switch( e->type ){
+        case ElemT_Float:
+            if( !emit(c, OpPush, 1) ){ return false; }
+            c->ops[c->len-1].arg.f = e->obj.f;
+            return true;
+        case ElemT_Dynamic: return compile_dyn(c, e->obj.dyn);
+        case ElemT_Mutable:
+            if( !emit(c, OpMutable, 0) ){ return false; }
+            c->ops[c->len-1].arg.ix = e->obj.var[0];
+            return compile_dyn(c, e->obj.var[0]);
+        case ElemT_Negate: return compile_dyn(c, e->obj.var[0]) && emit(c, OpNegate, 0);
+        case ElemT_Add: return compile_binary(c, e, OpAdd);
+        case ElemT_Sub: return compile_binary(c, e, OpSub);
+        case ElemT_Mul: return compile_binary(c, e, OpMul);
+        case ElemT_Div: return compile_binary(c, e, OpDiv);
+        case ElemT_Mod: return compile_binary(c, e, OpMod);
+        case ElemT_Mutate: return compile_dyn(c, e->obj.var[0]) && emit(c, OpMutate, 0);
+        case ElemT_Random: return emit(c, OpRandom, 1);
+        case ElemT_RandRange: return compile_binary(c, e, OpRange);
+        default: return false; // shapes, programs & stateful types aren't compiled
+    }
+}
+
+// replaces e with a reference to its program. leaves e untouched on failure
+static void compile( Casl* self, Elem* e )
+{
+    switch( e->type ){ // literals resolve directly
+        case ElemT_Float: case ElemT_Shape: case ElemT_Program: return;
+        default: break;
+    }
+    static Compiler c; // static as it's too large for the stack
+    c.len = 0; c.depth = 0; c.max = 0;
+    if( !compile_elem(&c, e)
+     || !emit(&c, OpEnd, 0)
+     || c.max > CASL_STACK ){
+        return;
+    }
+    int ix = pool_alloc_run(CaslPool_Code, self->index, c.len);
+    if( ix < 0 ){
+        printf("ERROR: no code slots left. using tree\n");
+        return;
+    }
+    for( int i=0; i<c.len; i++ ){ code[ix+i] = c.ops[i]; }
+    e->obj.dyn = ix;
+    e->type = ElemT_Program;
+}
+
+static void compile_all( Casl* self )
+{
+    for( int i=0; i<TO_COUNT; i++ ){
+        if( to_owner[i] != self->index ){ continue; }
+        To* t = &tos[i];
+        switch( t->ctrl ){
+            case ToLiteral:
+                compile(self, &t->a);
+                compile(self, &t->b); // c is a shape
+                break;
+            case ToIf: compile(self, &t->a); break;
+            default: break;
+        }
+    }
+}
+
+static float run( const CaslOp* pc )
+{
+    float stack[CASL_STACK];
+    float* sp = stack; // next free slot
+    uint16_t mutable = DYN_COUNT; // out of range
+    while(true){
+        switch( pc->op ){
+            case OpPush: *sp++ = pc->arg.f; break;
+            case OpLoad: *sp++ = dynamics[pc->arg.ix].obj.f; break;
+            case OpMutable: mutable = pc->arg.ix; break;
+            case OpNegate: sp[-1] = -sp[-1]; break;
+            case OpAdd: sp--; sp[-1] += sp[0]; break;
+            case OpSub: sp--; sp[-1] -= sp[0]; break;
+            case OpMul: sp--; sp[-1] *= sp[0]; break;
+            case OpDiv: sp--; sp[-1] /= sp[0]; break;
+            case OpMod:{ // see _resolve for negative handling
+                sp--;
+                float val  = sp[-1];
+                float wrap = sp[0];
+                sp[-1] = val - (wrap * floorf(val/wrap));
+                break;}
+            case OpRandom: *sp++ = Random_Float(); break;
+            case OpRange: sp--; sp[-1] += Random_Float() * (sp[0] - sp[-1]); break;
+            case OpMutate:
+                if(mutable < DYN_COUNT){
+                    dynamics[mutable].obj.f = sp[-1]; // update value
+                    mutable = DYN_COUNT; // mutation resolved!
+                }
+                break;
+            default: // OpEnd
+                if(mutable < DYN_COUNT){
+                    dynamics[mutable].obj.f = sp[-1]; // update value
+                }
+                return sp[-1];
+        }
+        pc++;
+    }
+}
+
 ////////////////////////////////////
 // Dynamic Variables
 // allows concurrent access of registered vars from C and Lua
 
+// returns a handle for Lua, rather than the slot
 int casl_defdynamic( int index )
 {
     if(index < 0 || index >= SELVES_COUNT){ return -1; }
-    return casl_defdynamicP(_selves[index]);
+    int ix = casl_defdynamicP(_selves[index]);
+    return (ix < 0) ? -1 : dyn_handle(ix);
 }
 
 int casl_defdynamicP( Casl* self )
 {
-    if(self->dyn_ix >= DYN_COUNT){
+    int ix = pool_alloc(CaslPool_Dyn, self->index);
+    if(ix < 0){
         printf("ERROR: no dynamic slots remain\n");
         Caw_printf("ERROR: no dynamic slots remain\n");
-        return -1;
     }
-    int ix = self->dyn_ix; self->dyn_ix++;
     return ix;
 }
 
 void casl_cleardynamics( int index )
 {
     if(index < 0 || index >= SELVES_COUNT){ return; }
-    Casl* self = _selves[index];
-
-    self->dyn_ix = 0;
+    pool_reclaim(CaslPool_Dyn, index);
 }
 
-void casl_setdynamic( int index, int dynamic_ix, float val )
+void casl_setdynamic( int index, int dynamic, float val )
 {
     if(index < 0 || index >= SELVES_COUNT){ return; }
-    Casl* self = _selves[index];
+    int dynamic_ix = dyn_slot(index, dynamic);
+    if(dynamic_ix < 0){ // reclaimed since it was defined. may belong to another channel
+        printf("setdynamic! stale dynamic\n");
+        return;
+    }
+
+    dynamics[dynamic_ix].obj.f = val;
+    dynamics[dynamic_ix].type  = ElemT_Float; // FIXME support other types
 
-    self->dynamics[dynamic_ix].obj.f = val;
-    self->dynamics[dynamic_ix].type  = ElemT_Float; // FIXME support other types
+    Casl* self = _selves[index];
+    if( self->ahead ){ // queued stages may hold the old value
+        BLOCK_IRQS( rewind_prefetch(self); );
+        request_prefetch(index);
+    }
 }
 
-float casl_getdynamic( int index, int dynamic_ix )
+float casl_getdynamic( int index, int dynamic )
 {
     if(index < 0 || index >= SELVES_COUNT){ return 0.0; }
-    Casl* self = _selves[index];
+    int dynamic_ix = dyn_slot(index, dynamic);
+    if(dynamic_ix < 0){ return 0.0; }
 
-    switch(self->dynamics[dynamic_ix].type){
+    switch(dynamics[dynamic_ix].type){
         case ElemT_Float:
-            return self->dynamics[dynamic_ix].obj.f;
+            return dynamics[dynamic_ix].obj.f;
         default:
             printf("getdynamic! wrong type\n");
             Caw_printf("getdynamic! wrong type\n");
@@ -9,10 +9,47 @@
 
 #include "slopes.h" // S_toward
 
-#define TO_COUNT   16   // 28bytes
-#define SEQ_COUNT  8    // 16bytes
-#define SEQ_LENGTH 8    // 4bytes
-#define DYN_COUNT  40   // 8bytes
+// node pools shared by all channels. each channel borrows as needed
+#define TO_COUNT   128  // 32bytes
+#define SEQ_COUNT  64   // 12bytes
+#define DYN_COUNT  256  // 8bytes
+#define CODE_COUNT 512  // 8bytes
+
+#define CASL_STACK 8 // max operand depth of a compiled element
+
+// layout of a sequins in the dynamics pool, followed by its values
+// stepped as sequins.lua's do_step: the index moves, then its value is returned
+#define SEQN_LENGTH 0 // obj.dyn: count of values
+#define SEQN_INDEX  1 // obj.dyn: index of the current value
+#define SEQN_SELECT 2 // obj.dyn: index used by the next step instead of stepping. -1 if none
+#define SEQN_STEP   3 // Elem: added to index before each value
+#define SEQN_VALUES 4
+
+// layout of a sample & hold in the dynamics pool
+#define SAH_SOURCE 0 // Elem: sampled when count expires
+#define SAH_PERIOD 1 // Elem: resolutions per sample
+#define SAH_COUNT  2 // obj.dyn: resolutions until the next sample
+#define SAH_VALUE  3 // obj: held value
+#define SAH_SIZE   4
+
+#define CASL_NIL 0xFFFF // empty node link
+
+#define CASL_PREFETCH_MS 20.0 // resolve segments this far ahead of the slope
+
+// binary description, as produced by Asl.serialize. little-endian, no alignment
+// a description is a single stage:
+//   'T' elem elem elem     to(volts, time, shape)
+//   'I' elem               if(predicate)
+//   'R' 'H' 'W' 'U' 'L' 'O' recur, held, wait, unheld, lock, open
+//   '[' stage... ']'       nested sequence
+// elem:
+//   'f' f32                number (booleans are 0 or 1)
+//   's' c c                shape, first 2 chars of its name
+//   'D' u16 | 'N' u16      dynamic | named mutable, by casl_defdynamic handle
+//   'M' '~' '#' elem       mutable, negate, mutate
+//   '+' '-' '*' '/' '%' 'R' 'H' elem elem    ops, random range, sample & hold
+//   'r'                    random [0,1)
+//   'S' u16 i16 i16 elem elem...  sequins: count, lua ix, lua set_ix (0 if none), step, values
 
 typedef enum{ ToLiteral
             , ToRecur
@@ -45,6 +82,13 @@ typedef enum{ ElemT_Float
             , ElemT_Div
             , ElemT_Mod
             , ElemT_Mutate
+        // stateful
+            , ElemT_Sequins // obj.var[0] is the first of a run of dynamics. see SEQN_*
+            , ElemT_Random  // uniform [0,1)
+            , ElemT_RandRange // uniform [var[0],var[1])
+            , ElemT_SampleHold // obj.var[0] is the first of a run of dynamics. see SAH_*
+        // compiled to bytecode
+            , ElemT_Program // obj.dyn is the offset into the code pool
 } ElemT;
 
 typedef struct{
@@ -52,43 +96,92 @@ typedef struct{
     ElemT type;
 } Elem; // 8bytes
 
+// bytecode for a stack machine, compiled from an Elem tree in postfix order
+typedef enum{ OpPush    // push literal
+            , OpLoad    // push dynamic
+            , OpMutable // select dynamic to receive the result
+            , OpNegate
+            , OpAdd
+            , OpSub
+            , OpMul
+            , OpDiv
+            , OpMod
+            , OpMutate  // write top of stack to the selected dynamic
+            , OpRandom  // push uniform [0,1)
+            , OpRange   // replace min & max with a uniform value between
+            , OpEnd     // return top of stack
+} CaslOpcode;
+
+typedef struct{
+    uint8_t op; // CaslOpcode
+    union{
+        float    f;
+        uint16_t ix; // into the dynamics pool
+    } arg;
+} CaslOp; // 8bytes
+
 typedef struct{
     Elem a;
     Elem b;
     Elem c;
     ToControl ctrl;
-} To; // 28bytes
+    uint16_t next; // following stage in the same Sequence
+} To; // 32bytes
 
+// stages are a linked list of To nodes, so length is only limited by the pool
 typedef struct{
-    To* stage[SEQ_LENGTH];
-    int length;
-    int pc;
+    uint16_t head; // first stage
+    uint16_t tail; // last stage, for appending
+    uint16_t pc;   // next stage to execute. CASL_NIL when complete
+    uint16_t length;
     int parent; // seq_ix, like a tree 'parent' link
-} Sequence;
+} Sequence; // 12bytes
+
+typedef enum{ CaslPool_To
+            , CaslPool_Seq
+            , CaslPool_Dyn
+            , CaslPool_Code
+            , CaslPool_Count
+} CaslPool;
+
+typedef struct{
+    int size;
+    int used;
+    int high; // high-water mark
+} CaslPoolStats;
 
 // TODO rename 'dynamics' to 'elements' and use it as a general abstraction (eg with To*)
 typedef struct{
-    To tos[TO_COUNT];
-    int to_ix;
+    int index; // owner id in the shared pools
 
     Sequence* seq_current;
-    Sequence seqs[SEQ_COUNT];
-    int seq_ix;
+    int seq_root;
     int seq_select;
 
-    Elem dynamics[DYN_COUNT];
-    int dyn_ix;
-
     bool holding;
     bool locked;
+    volatile bool prefetching; // refill event is queued
+    volatile bool acting; // casl_action is walking the sequence. breakpoints wait for it
+    uint16_t played; // pc of the first stage in the slope queue
+    int ahead; // stages the pc has advanced past playback, ie. in the slope queue
+    int optimized; // nodes saved by the optimizer on last describe
+    uint16_t direct; // To reused by casl_to. CASL_NIL when described from Lua
 } Casl;
 
 Casl* casl_init( int index );
 void casl_describe( int index, lua_State* L );
+void casl_describe_bin( int index, const char* data, size_t len ); // see format above
 void casl_action( int index, int action );
+void casl_to( int index, float volts, float seconds, Shape_t shape ); // no lua, no allocation
 
 // dynamic vars
-int casl_defdynamic( int index );
+// handles are invalidated when the channel's dynamics are reclaimed
+int casl_defdynamic( int index ); // returns a handle, or -1
 void casl_cleardynamics( int index );
-void casl_setdynamic( int index, int dynamic_ix, float val );
-float casl_getdynamic( int index, int dynamic_ix );
+void casl_setdynamic( int index, int dynamic, float val ); // ignored if stale
+float casl_getdynamic( int index, int dynamic ); // 0.0 if stale
+
+// shared pool usage
+CaslPoolStats casl_arena_stats( CaslPool pool );
+int casl_arena_owned( int index, CaslPool pool ); // nodes held by one channel
+int casl_optimized( int index ); // nodes saved by the optimizer on last describe
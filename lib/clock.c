@@ -5,7 +5,10 @@
 #include <math.h>
 
 #include "lualink.h"
-#include <stm32f7xx_hal.h> // HAL_GetTick
+#include <stm32f7xx_hal.h> // BLOCK_IRQS
+#include "io.h" // IO_GetSampleTime()
+#include "casl.h" // casl_action()
+#include "events.h" // event_post() for clocked asl pulses
 
 
 ///////////////////////////////
@@ -18,9 +21,12 @@ typedef struct{
 } clock_reference_t;
 
 typedef struct{
-    uint32_t wakeup;
-    int      coro_id;
-    bool     running;
+    uint64_t wakeup;    // in samples
+    int      coro_id;   // or ASL_CORO(channel) for a clocked asl
+    float    beats;     // clocked asl: division to resync to after each pulse
+    volatile bool pending; // clocked asl: pulse posted & not yet handled
+    int      heap_ix;   // position in the wakeup heap. -1 when idle
+    int      next_free; // free list link while idle
 } clock_thread_t;
 
 typedef struct{
@@ -29,17 +35,27 @@ typedef struct{
     bool   running;
 } clock_thread_HD_t;
 
+// clocked asl entries are kept in the heap with negative ids, below the idle -1
+#define ASL_CORO(ch) (-2 - (ch)) // its own inverse
+
 ////////////////////////////////////
 // global data
 
 static int clock_count;
 static clock_thread_t* clock_pool;
+static int* heap; // indices into clock_pool, as a min-heap on wakeup
+static int heap_len;
+static int free_head; // first idle slot in clock_pool, or -1
 static clock_thread_HD_t internal; // for internal clocksource
 static clock_source_t clock_source = CLOCK_SOURCE_INTERNAL;
 
 static clock_reference_t reference;
 
-static uint32_t last_tick = 0;
+static volatile bool ready = false; // wakeup heap is allocated
+static float sample_rate;
+
+// lateness of resumes, in CLOCK_JITTER_US wide bins. the last bin counts everything later
+static uint32_t jitter[ CLOCK_JITTER_BINS ];
 
 
 /////////////////////////////////////////////
@@ -47,8 +63,14 @@ static uint32_t last_tick = 0;
 
 static int find_idle(void);
 static void clock_cancel( int index );
+static void clock_free_all( void );
+static void heap_push( int slot );
+static void heap_remove( int pos );
+static double sync_delay( double now, float beats );
+static void asl_pulse( int slot );
+static void reference_set( double beats, double beat_duration, double time );
 
-void clock_internal_run(uint32_t ms);
+void clock_internal_run( double seconds );
 
 /////////////////////////////////////////////
 // public defs
@@ -57,13 +79,14 @@ void clock_init( int max_clocks )
 {
     clock_count = max_clocks;
     clock_pool = malloc( sizeof(clock_thread_t) * clock_count );
-    for( int i=0; i<clock_count; i++ ){
-        clock_pool[i].running = false;
-    }
+    heap = malloc( sizeof(int) * clock_count );
+    clock_free_all();
+
+    sample_rate = IO_GetSampleRate();
+    ready = true;
 
     clock_set_source( CLOCK_SOURCE_INTERNAL );
     clock_update_reference(0, 0.5);
-    last_tick = HAL_GetTick();
 
     // start clock sources
     clock_internal_init();
@@ -71,82 +94,142 @@ void clock_init( int max_clocks )
 }
 
 
-// TODO give clock it's own Timer to avoid this check & run in background
+// wakeups are handled in clock_block. this only advances the internal clock source
 void clock_update(void)
 {
-    uint32_t time_now = HAL_GetTick();
-    if( last_tick != time_now ){ // next tick
-        last_tick = time_now;
-
-        clock_internal_run(time_now);
+    clock_internal_run( clock_get_time_seconds() );
+}
 
-        // TODO check for events
-        // re-order the list whenever inserting new events
-        // so the check code can just look at the front of the list
-        // might need 2 separate (1 for sleep, 1 for sync)
+// called from the audio ISR at the start of each block
+// wakeups resolve to the block in which they fall due, so lateness is under one block
+void clock_block( void )
+{
+    if( !ready ){ return; }
+
+    uint64_t now = IO_GetSampleTime();
+    // earliest wakeup is at the front, so only expired entries are visited
+    while( heap_len && clock_pool[heap[0]].wakeup <= now ){
+        int slot = heap[0];
+        clock_thread_t* t = &clock_pool[slot];
+        heap_remove(0);
+        if( t->coro_id <= ASL_CORO(0) ){ // clocked asl. restart & resync without lua
+            asl_pulse( slot );
+            // from now rather than the missed wakeup, so a late block can't burst
+            // and half a division on, so a reference nudged backwards can't refire this beat
+            double half = (double)reference.beat_duration * (double)t->beats / (double)2.0;
+            double delay = half + sync_delay( (double)now / (double)sample_rate + half
+                                            , t->beats );
+            uint64_t next = now + (uint64_t)( delay * (double)sample_rate + (double)0.5 );
+            t->wakeup = (next > now) ? next : now + 1;
+            heap_push(slot);
+        } else {
+            L_queue_clock_wakeup( t->coro_id, (uint32_t)t->wakeup );
+            clock_cancel(slot);
+        }
+    }
+}
 
-        // for now we just check every entry!
-        for( int i=0; i<clock_count; i++ ){
-            if( clock_pool[i].running ){
-                if( clock_pool[i].wakeup < time_now ){
-                    // event!
-                    // TODO pop from ordered list
-                    L_queue_clock_resume( clock_pool[i].coro_id );
+// called as the resume is handled. wakeup is the low 32bits of the scheduled sample
+void clock_record_jitter( uint32_t wakeup )
+{
+    double now = IO_GetSampleTimePrecise();
+    double late = (double)(int32_t)((uint32_t)(uint64_t)now - wakeup) + (now - floor(now));
+    int bin = (int)(late * (double)1000000.0 / (double)sample_rate) / CLOCK_JITTER_US;
+    if( bin < 0 ){ bin = 0; }
+    if( bin >= CLOCK_JITTER_BINS ){ bin = CLOCK_JITTER_BINS-1; }
+    jitter[bin]++;
+}
 
-                    // i think this is coro cancel?
-                    clock_pool[i].running = false;
-                }
-            }
-        }
+const uint32_t* clock_get_jitter( bool reset )
+{
+    static uint32_t copy[ CLOCK_JITTER_BINS ];
+    for( int i=0; i<CLOCK_JITTER_BINS; i++ ){
+        copy[i] = jitter[i];
+        if( reset ){ jitter[i] = 0; }
     }
+    return copy;
 }
 
 bool clock_schedule_resume_sleep( int coro_id, float seconds )
 {
+    uint64_t wakeup = (uint64_t)(IO_GetSampleTimePrecise()
+                                 + (double)seconds * (double)sample_rate
+                                 + (double)0.5);
     int i;
-    if( (i = find_idle()) >= 0 ){
-        // TODO just mark the index as busy
-            // the following data should only be in the ordered list
-            // which should have a 'length' marker
-        clock_pool[i].coro_id  = coro_id;
-        clock_pool[i].running  = true;
-        clock_pool[i].wakeup   = HAL_GetTick() + (uint32_t)(seconds * 1000.0);
-        return true;
-    }
-    return false;
+    BLOCK_IRQS( // heap is shared with clock_block
+        if( (i = find_idle()) >= 0 ){
+            clock_pool[i].coro_id  = coro_id;
+            clock_pool[i].wakeup   = wakeup;
+            heap_push(i);
+        }
+    );
+    return (i >= 0);
 }
 
 bool clock_schedule_resume_sync( int coro_id, float beats )
 {
-    double zero_beat_time;
-    double this_beat;
-    double next_beat;
-    double next_beat_time;
-    int next_beat_multiplier = 0;
+    return clock_schedule_resume_sleep( coro_id
+                                      , (float)sync_delay( clock_get_time_seconds()
+                                                         , beats ) );
+}
 
-    double current_time = clock_get_time_seconds();
-    zero_beat_time = reference.last_beat_time
-                        - ((double)reference.beat_duration * reference.beat);
-    this_beat = (current_time - zero_beat_time) / (double)reference.beat_duration;
+// retrigger an output's asl on every multiple of beats, until cancelled
+bool clock_schedule_asl( int index, float beats )
+{
+    clock_cancel_asl( index ); // replace an existing subscription
+    if( beats <= 0.0 ){ return false; }
+
+    double now = IO_GetSampleTimePrecise();
+    uint64_t wakeup = (uint64_t)( now
+                                + sync_delay( now / (double)sample_rate, beats )
+                                    * (double)sample_rate
+                                + (double)0.5 );
+    int i;
+    BLOCK_IRQS( // heap is shared with clock_block
+        if( (i = find_idle()) >= 0 ){
+            clock_pool[i].coro_id = ASL_CORO(index);
+            clock_pool[i].beats   = beats;
+            clock_pool[i].wakeup  = wakeup;
+            heap_push(i);
+        }
+    );
+    return (i >= 0);
+}
 
-    do{
-        next_beat_multiplier += 1;
+void clock_cancel_asl( int index )
+{
+    clock_cancel_coro( ASL_CORO(index) );
+}
 
-        next_beat = (floor(this_beat / (double)beats) + next_beat_multiplier)
-                        * (double)beats;
-        next_beat_time = zero_beat_time + (next_beat * (double)reference.beat_duration);
-    } while( next_beat_time - current_time
-           < (double)reference.beat_duration * (double)beats / (double)2000.0 );
+// the ISR only flags the pulse. the restart runs in the event loop, which owns the
+// channel's casl state. a pulse due while one is still pending is merged into it
+static void handle_asl_pulse( event_t* e );
 
-    return clock_schedule_resume_sleep( coro_id
-                                      , (float)(next_beat_time - current_time) );
+static void asl_pulse( int slot )
+{
+    clock_thread_t* t = &clock_pool[slot];
+    if( t->pending ){ return; }
+    t->pending = true;
+    event_t e = { .handler = handle_asl_pulse
+                , .index.i = slot
+                , .data.i  = (int)(uint32_t)t->wakeup // target sample, for jitter
+                };
+    if( !event_post(&e) ){ t->pending = false; }
+}
+
+static void handle_asl_pulse( event_t* e )
+{
+    clock_thread_t* t = &clock_pool[e->index.i];
+    if( !t->pending ){ return; } // cancelled since the pulse was posted
+    t->pending = false;
+    if( t->coro_id > ASL_CORO(0) ){ return; }
+    clock_record_jitter( (uint32_t)e->data.i );
+    casl_action( ASL_CORO(t->coro_id), 1 );
 }
 
 void clock_update_reference(double beats, double beat_duration)
 {
-    reference.beat_duration  = beat_duration;
-    reference.last_beat_time = clock_get_time_seconds();
-    reference.beat           = beats;
+    reference_set( beats, beat_duration, clock_get_time_seconds() );
 }
 
 void clock_update_reference_from(double beats, double beat_duration, clock_source_t source)
@@ -187,7 +270,7 @@ float clock_get_time_beats(void)
 
 double clock_get_time_seconds(void)
 {
-    return (double)HAL_GetTick() / (double)1000.0;
+    return IO_GetSampleTimePrecise() / (double)sample_rate;
 }
 
 float clock_get_tempo(void)
@@ -197,39 +280,144 @@ float clock_get_tempo(void)
 
 void clock_cancel_coro( int coro_id )
 {
-    // TODO optimize search by looking through the 'active' list only
-    for( int i=0; i<clock_count; i++ ){
-        if( clock_pool[i].coro_id == coro_id ){
-            clock_cancel(i);
+    BLOCK_IRQS( // heap is shared with clock_block
+        // only the scheduled entries. backwards, as removal moves the last entry into i
+        for( int i=heap_len-1; i>=0; i-- ){
+            int slot = heap[i];
+            if( clock_pool[slot].coro_id == coro_id ){
+                heap_remove(i);
+                clock_cancel(slot);
+            }
         }
-    }
+    );
 }
 
 void clock_cancel_coro_all( void )
 {
-    for( int i=0; i<clock_count; i++ ){
-        clock_cancel(i);
-    }
+    BLOCK_IRQS( clock_free_all(); );
 }
 
 ////////////////////////////////////////////
 // private defs
 
+static void reference_set( double beats, double beat_duration, double time )
+{
+    BLOCK_IRQS( // clocked asl reads the reference from clock_block
+        reference.beat_duration  = beat_duration;
+        reference.last_beat_time = time;
+        reference.beat           = beats;
+    );
+}
+
+// seconds from now until the next multiple of beats
+static double sync_delay( double now, float beats )
+{
+    double zero_beat_time;
+    double this_beat;
+    double next_beat;
+    double next_beat_time;
+    int next_beat_multiplier = 0;
+
+    zero_beat_time = reference.last_beat_time
+                        - ((double)reference.beat_duration * reference.beat);
+    this_beat = (now - zero_beat_time) / (double)reference.beat_duration;
+
+    do{
+        next_beat_multiplier += 1;
+
+        next_beat = (floor(this_beat / (double)beats) + next_beat_multiplier)
+                        * (double)beats;
+        next_beat_time = zero_beat_time + (next_beat * (double)reference.beat_duration);
+    } while( next_beat_time - now
+           < (double)reference.beat_duration * (double)beats / (double)2000.0 );
+
+    return next_beat_time - now;
+}
+
 static int find_idle(void)
 {
-    // TODO optimize by starting search from last successful slot
-    for( int i=0; i<clock_count; i++ ){
-        if( !clock_pool[i].running ){
-            return i;
-        }
-    }
-    return -1;
+    int i = free_head;
+    if( i >= 0 ){ free_head = clock_pool[i].next_free; }
+    return i;
 }
 
+// return an unscheduled slot to the free list
 static void clock_cancel( int index )
 {
-    clock_pool[index].running = false;
-    clock_pool[index].coro_id = -1;
+    clock_pool[index].heap_ix   = -1;
+    clock_pool[index].coro_id   = -1;
+    clock_pool[index].pending   = false;
+    clock_pool[index].next_free = free_head;
+    free_head = index;
+}
+
+static void clock_free_all( void )
+{
+    heap_len  = 0;
+    free_head = -1;
+    for( int i=clock_count-1; i>=0; i-- ){
+        clock_cancel(i);
+    }
+}
+
+
+////////////////////////////////////////////
+// wakeup heap
+
+static bool heap_earlier( int a, int b )
+{
+    return clock_pool[heap[a]].wakeup < clock_pool[heap[b]].wakeup;
+}
+
+static void heap_set( int pos, int slot )
+{
+    heap[pos] = slot;
+    clock_pool[slot].heap_ix = pos;
+}
+
+static void heap_swap( int a, int b )
+{
+    int slot = heap[a];
+    heap_set( a, heap[b] );
+    heap_set( b, slot );
+}
+
+static int sift_up( int pos )
+{
+    while( pos > 0 ){
+        int parent = (pos - 1) >> 1;
+        if( !heap_earlier( pos, parent ) ){ break; }
+        heap_swap( pos, parent );
+        pos = parent;
+    }
+    return pos;
+}
+
+static void sift_down( int pos )
+{
+    while( true ){
+        int first = pos;
+        int l = 2*pos + 1;
+        int r = l + 1;
+        if( l < heap_len && heap_earlier( l, first ) ){ first = l; }
+        if( r < heap_len && heap_earlier( r, first ) ){ first = r; }
+        if( first == pos ){ break; }
+        heap_swap( pos, first );
+        pos = first;
+    }
+}
+
+static void heap_push( int slot )
+{
+    heap_set( heap_len, slot );
+    sift_up( heap_len++ );
+}
+
+static void heap_remove( int pos )
+{
+    if( --heap_len == pos ){ return; } // was the last entry
+    heap_set( pos, heap[heap_len] );
+    sift_down( sift_up( pos ) );
 }
 
 
@@ -275,16 +463,15 @@ void clock_internal_stop(void)
 /////////////////////////////////////
 // private clock_internal
 
-void clock_internal_run(uint32_t ms)
+void clock_internal_run( double time_now )
 {
     if( internal.running ){
-        double time_now = ms;
         if( internal.wakeup < time_now ){
             internal_beat += 1;
             clock_update_reference_from( internal_beat
                                        , internal_interval_seconds
                                        , CLOCK_SOURCE_INTERNAL );
-            internal.wakeup = time_now + internal_interval_seconds * (double)1000.0;
+            internal.wakeup = time_now + internal_interval_seconds;
         }
     }
 }
@@ -293,17 +480,27 @@ void clock_internal_run(uint32_t ms)
 /////////////////////////////////////////////////
 // in clock_input.h
 
-static bool clock_crow_last_time_set;
-static int clock_crow_counter;
-static double clock_crow_last_time;
-
-#define DURATION_BUFFER_LENGTH 4
-
-static float duration_buf[DURATION_BUFFER_LENGTH] = {0};
-static uint8_t beat_duration_buf_pos = 0;
-static uint8_t beat_duration_buf_len = 0;
-static float mean_sum;
-static float mean_scale;
+// edges are tracked by an alpha-beta filter (a steady-state kalman filter) on
+// pulse phase & period. the reference is anchored to the filtered edge, so input
+// jitter doesn't shake the beat grid & sync wakeups land on the predicted beat
+// rather than following the edge.
+
+#define CROW_TIMEOUT      ((double)4.0)  // beat length (s) beyond which the clock is assumed stopped
+#define CROW_OUTLIER      ((double)0.35) // phase error in periods beyond which an edge is distrusted
+#define CROW_REACQUIRE    3              // consecutive outliers before the period is re-measured
+#define CROW_LOCK_COUNT   8              // consecutive trusted edges before locking
+#define CROW_ACQUIRE_GAIN ((double)0.5)  // minimum phase gain while unlocked, for fast pull-in
+
+static int    clock_crow_counter;
+static int    crow_edges;    // 0: waiting for an edge. 1: for the first interval
+static double crow_phase;    // filtered time of the last edge
+static double crow_period;   // filtered time between edges
+static double crow_error;    // phase error of the last edge. positive is late
+static double crow_raw_last; // unfiltered time of the last edge
+static int    crow_outliers;
+static int    crow_trusted;
+static bool   crow_locked;
+static float  crow_smoothing = 0.75;
 
 static float crow_in_div = 4.0;
 
@@ -311,8 +508,9 @@ static float crow_in_div = 4.0;
 void clock_crow_init(void)
 {
     clock_crow_counter = 0;
-    clock_crow_last_time_set = false;
-    mean_sum = 0;
+    crow_edges = 0;
+    crow_error = 0.0;
+    crow_locked = false;
 }
 
 // called by an event received on input
@@ -321,41 +519,86 @@ void clock_input_handler( int id, float freq )
     // this stub function just ignores the args
     clock_crow_handle_clock();
 }
-void clock_crow_handle_clock(void)
+
+static void crow_restart( double t )
 {
-    float beat_duration;
-    double current_time = clock_get_time_seconds();
+    crow_edges    = 1;
+    crow_phase    = t;
+    crow_raw_last = t;
+    crow_outliers = 0;
+    crow_trusted  = 0;
+    crow_locked   = false;
+}
 
-    if( clock_crow_last_time_set == false ){
-        clock_crow_last_time_set = true;
-        clock_crow_last_time = current_time;
-    } else {
-        beat_duration = (float)(current_time - clock_crow_last_time)
-                            * crow_in_div;
-        if( beat_duration > 4.0 ){ // assume clock stopped
-            clock_crow_last_time = current_time;
-        } else {
-            if( beat_duration_buf_len < DURATION_BUFFER_LENGTH ){
-                beat_duration_buf_len++;
-                mean_scale = 1.0 / beat_duration_buf_len;
-            }
+// called from Detect in the audio ISR, on the last sample of the block
+void clock_crow_handle_clock(void)
+{
+    double t = (double)IO_GetSampleTime() / (double)sample_rate;
 
-            float a = beat_duration * mean_scale;
-            mean_sum = mean_sum + a;
-            mean_sum = mean_sum - duration_buf[beat_duration_buf_pos];
-            duration_buf[beat_duration_buf_pos] = a;
-            beat_duration_buf_pos = (beat_duration_buf_pos + 1) % DURATION_BUFFER_LENGTH;
+    if( crow_edges == 0 ){ crow_restart(t); return; }
 
-            clock_crow_counter++;
-            clock_crow_last_time = current_time;
+    double interval = t - crow_raw_last;
+    crow_raw_last = t;
+    if( interval * (double)crow_in_div > CROW_TIMEOUT ){ // assume clock stopped
+        crow_restart(t);
+        return;
+    }
 
-            double beat = clock_crow_counter / crow_in_div;
-            clock_update_reference_from(beat, (double)mean_sum, CLOCK_SOURCE_CROW);
+    if( crow_edges == 1 ){ // first interval seeds the period
+        crow_edges  = 2;
+        crow_phase  = t;
+        crow_period = interval;
+        crow_error  = 0.0;
+    } else {
+        double predicted = crow_phase + crow_period;
+        double err = t - predicted;
+        crow_error = err;
+        if( fabs(err) > CROW_OUTLIER * crow_period ){
+            crow_trusted = 0;
+            crow_locked  = false;
+            if( ++crow_outliers >= CROW_REACQUIRE ){ // tempo has changed. measure afresh
+                crow_outliers = 0;
+                crow_period   = interval;
+            }
+            crow_phase = t; // follow the edge, keeping the period
+        } else {
+            crow_outliers = 0;
+            if( ++crow_trusted >= CROW_LOCK_COUNT ){ crow_locked = true; }
+            double alpha = (double)1.0 - (double)crow_smoothing;
+            if( !crow_locked && alpha < CROW_ACQUIRE_GAIN ){ alpha = CROW_ACQUIRE_GAIN; }
+            double beta = alpha * alpha / ((double)2.0 - alpha); // critically damped
+            crow_phase  = predicted + alpha * err;
+            crow_period = crow_period + beta * err;
         }
     }
+
+    clock_crow_counter++;
+    if( clock_source == CLOCK_SOURCE_CROW ){
+        reference_set( clock_crow_counter / (double)crow_in_div
+                     , crow_period * (double)crow_in_div
+                     , crow_phase
+                     );
+    }
 }
 
 void clock_crow_in_div( float div )
 {
     crow_in_div = 1.0/div;
 }
+
+void clock_crow_smoothing( float smoothing )
+{
+    if( smoothing < 0.0 ){ smoothing = 0.0; }
+    if( smoothing > 0.99 ){ smoothing = 0.99; } // 1 would never follow the input
+    crow_smoothing = smoothing;
+}
+
+bool clock_crow_locked( void )
+{
+    return crow_locked;
+}
+
+double clock_crow_error( void )
+{
+    return crow_error;
+}
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
+
+#define CLOCK_JITTER_BINS 16
+#define CLOCK_JITTER_US   250 // width of a jitter histogram bin
 
 typedef enum{ CLOCK_SOURCE_INTERNAL = 0
             , CLOCK_SOURCE_MIDI     = 1
@@ -11,8 +15,12 @@ typedef enum{ CLOCK_SOURCE_INTERNAL = 0
 
 void clock_init( int max_clocks );
 
-// FIXME just polling for changes rn
-void clock_update(void);
+void clock_update(void); // main loop: internal clock source
+void clock_block( void ); // audio ISR: wakeups on the IO sample counter
+
+// lateness of resumes & clocked asl pulses, from scheduled sample to the handler
+void clock_record_jitter( uint32_t wakeup );
+const uint32_t* clock_get_jitter( bool reset ); // CLOCK_JITTER_BINS counts
 
 bool clock_schedule_resume_sleep( int coro_id, float seconds );
 bool clock_schedule_resume_sync( int coro_id, float beats );
@@ -29,6 +37,10 @@ float clock_get_tempo(void);
 void clock_cancel_coro( int coro_id );
 void clock_cancel_coro_all( void );
 
+// clocked asl: casl channel index is restarted at each division, without lua
+bool clock_schedule_asl( int index, float beats );
+void clock_cancel_asl( int index );
+
 
 ///////////////////////////////////
 // internal
@@ -47,3 +59,7 @@ void clock_crow_init(void);
 void clock_input_handler( int id, float freq ); // Called from Detect lib
 void clock_crow_handle_clock(void);
 void clock_crow_in_div( float div );
+void clock_crow_smoothing( float smoothing ); // 0 follows each edge. towards 1 is steadier
+bool clock_crow_locked( void );
+double clock_crow_error( void ); // phase error of the last edge in seconds
+
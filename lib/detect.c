@@ -5,6 +5,7 @@
 #include <stdio.h>
 
 uint8_t channel_count = 0;
+static float block_rate = 1500.0; // blocks per second. set by Detect_init()
 
 Detect_t*  selves = NULL;
 
@@ -25,8 +26,9 @@ static void d_freq( Detect_t* self, float level );
 ///////////////////////////////////////////
 // init
 
-void Detect_init( int channels )
+void Detect_init( int channels, float blocks_per_second )
 {
+    block_rate = blocks_per_second;
     channel_count = channels;
     selves = malloc( sizeof ( Detect_t ) * channels );
     for( int j=0; j<channels; j++ ){
@@ -85,8 +87,7 @@ void Detect_stream( Detect_t*         self
     if( self->channel == 0 ){ clear_ch_one(); }
     self->modefn         = d_stream;
     self->action         = cb;
-    // SAMPLE_RATE * i / BLOCK_SIZE
-    self->stream.blocks  = (int)((48000.0 * interval) / 32.0);
+    self->stream.blocks  = (int)(block_rate * interval);
     if( self->stream.blocks <= 0 ){ self->stream.blocks = 1; }
     self->stream.countdown = self->stream.blocks;
 }
@@ -169,8 +170,7 @@ void Detect_volume( Detect_t*         self
     self->action         = cb;
 
     VU_time( self->vu, 0.018 );
-    // SAMPLE_RATE * i / BLOCK_SIZE
-    self->volume.blocks  = (int)((48000.0 * interval) / 32.0);
+    self->volume.blocks  = (int)(block_rate * interval);
     if( self->volume.blocks <= 0 ){ self->volume.blocks = 1; }
     self->volume.countdown = self->volume.blocks;
 }
@@ -205,13 +205,12 @@ void Detect_freq( Detect_t*         self
 
         // below is same as 'stream'
         self->action = cb;
-        // SAMPLE_RATE * i / BLOCK_SIZE
-        self->stream.blocks  = (int)((48000.0 * interval) / 32.0);
+        self->stream.blocks  = (int)(block_rate * interval);
         if( self->stream.blocks <= 0 ){ self->stream.blocks = 1; }
         self->stream.countdown = self->stream.blocks;
 
         FTrack_init();
-        FTrack_start();
+        FTrack_start( block_rate );
     }
 }
 
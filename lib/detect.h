@@ -81,7 +81,7 @@ typedef void (*Detect_mode_fn_t)(Detect_t* self, float level);
 ////////////////////////////////////
 // init
 
-void Detect_init( int channels );
+void Detect_init( int channels, float block_rate );
 void Detect_deinit( void );
 
 
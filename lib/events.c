@@ -5,83 +5,411 @@
 #include "events.h"
 #include "lualink.h"
 #include "caw.h" // Caw_send_luachunk
+#include "../ll/interrupts.h" // *_IRQPriority identify the posting context
 
 
 /// NOTE: if we are ever over-filling the event queue, we have problems.
 /// making the event queue bigger not likely to solve the problems.
-#define MAX_EVENTS   40
 
-// macro for incrementing an index into a circular buffer.
-#define INCR_EVENT_INDEX( x )  { if ( ++x == MAX_EVENTS ) x = 0; }
+// lock-free rings, one per lane for each producing context
+// sizes must be powers of 2
+#define RING_TIMING_EVENTS 16
+#define RING_BULK_EVENTS   32
 
-// get/put indexes into sysEvents[] array
-volatile static int putIdx = 0;
-volatile static int getIdx = 0;
+// locked queues for any other context (eg. system exceptions)
+#define TIMING_EVENTS 8
+#define BULK_EVENTS   8
 
-// the system event queue is a circular array of event records
-// NOTE be aware of event_t and MAX_EVENTS for RAM usage
-volatile static event_t sysEvents[ MAX_EVENTS ];
+// single-producer / single-consumer ring. the consumer is always the main loop
+// head & tail count up forever, & are masked to index the slots
+// one slot is kept empty, so the slot being copied by the consumer is never reused
+typedef struct{
+    volatile uint16_t head; // next write. only changed by the producer
+    volatile uint16_t tail; // next read. only changed by the consumer
+    uint16_t mask;
+    volatile event_t* events;
+    event_lane_stats_t stats; // only changed by the producer
+} ring_t;
+
+// each locked lane is a circular array of event records
+// NOTE be aware of event_t and lane sizes for RAM usage
+typedef struct{
+    volatile int putIdx; // last written
+    volatile int getIdx; // last read. queue is empty when equal
+    int size;
+    volatile event_t* events;
+    event_lane_stats_t stats;
+    const char* full_msg;
+} lane_t;
+
+volatile static event_t timingRingEvents[ EVENT_SRC_COUNT ][ RING_TIMING_EVENTS ];
+volatile static event_t bulkRingEvents[ EVENT_SRC_COUNT ][ RING_BULK_EVENTS ];
+static ring_t rings[ EVENT_LANE_COUNT ][ EVENT_SRC_COUNT ];
+static uint8_t ring_next[ EVENT_LANE_COUNT ]; // round-robin between producers
+
+volatile static event_t timingEvents[ TIMING_EVENTS ];
+volatile static event_t bulkEvents[ BULK_EVENTS ];
+
+// ordered by dispatch priority
+static lane_t lanes[ EVENT_LANE_COUNT ] =
+    { [EVENT_LANE_Timing] = { .size = TIMING_EVENTS
+                            , .events = timingEvents
+                            , .full_msg = "event queue full! (timing)"
+                            }
+    , [EVENT_LANE_Bulk]   = { .size = BULK_EVENTS
+                            , .events = bulkEvents
+                            , .full_msg = "event queue full! (bulk)"
+                            }
+    };
+
+// macro for incrementing an index into a lane's circular buffer.
+#define INCR_EVENT_INDEX( l, x )  { if ( ++x == (l)->size ) x = 0; }
+
+// drain budget in cpu cycles, as measured by the DWT cycle counter
+static uint32_t budget_cycles = 0;
+static event_stats_t stats = {0};
+
+static uint8_t coalesce = 1; // event_post_latest replaces pending events
+
+typedef void (*handler_fn)( event_t* e );
+
+// handlers that can take a burst of their events in one call
+#define BATCH_KINDS 4
+typedef struct{
+    handler_fn handler;
+    event_batch_fn batch;
+} batch_t;
+static batch_t batches[ BATCH_KINDS ];
+static int batch_count = 0;
 
 // initialize event handler
 void events_init() {
     printf("\ninitializing event handler\n");
 
+    // enable the cycle counter for timing the drain budget
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+    events_set_budget( EVENTS_BUDGET_US );
+
+    for( int s=0; s<EVENT_SRC_COUNT; s++ ){
+        rings[EVENT_LANE_Timing][s] = (ring_t){ .mask   = RING_TIMING_EVENTS - 1
+                                              , .events = timingRingEvents[s]
+                                              };
+        rings[EVENT_LANE_Bulk][s]   = (ring_t){ .mask   = RING_BULK_EVENTS - 1
+                                              , .events = bulkRingEvents[s]
+                                              };
+    }
+
     events_clear();
 }
 
+void events_set_budget( uint32_t microseconds )
+{
+    budget_cycles = microseconds * (SystemCoreClock / 1000000);
+}
+
+event_stats_t events_get_stats( void )
+{
+    return stats;
+}
+
+// summed over the producers. peak is the deepest single queue
+event_lane_stats_t events_get_lane_stats( event_lane_t lane )
+{
+    if( (int)lane < 0 || lane >= EVENT_LANE_COUNT ){ return (event_lane_stats_t){0}; }
+    event_lane_stats_t sum = lanes[lane].stats;
+    for( int s=0; s<EVENT_SRC_COUNT; s++ ){
+        event_lane_stats_t* r = &rings[lane][s].stats;
+        sum.posted    += r->posted;
+        sum.dropped   += r->dropped;
+        sum.coalesced += r->coalesced;
+        if( r->peak > sum.peak ){ sum.peak = r->peak; }
+    }
+    return sum;
+}
+
 void events_clear(void)
 {
-    // set queue (circular list) to empty
-    putIdx = 0;
-    getIdx = 0;
+    for( int i=0; i<EVENT_LANE_COUNT; i++ ){
+        // discard pending ring events. moving tail is the consumer's right, so no lock
+        for( int s=0; s<EVENT_SRC_COUNT; s++ ){
+            rings[i][s].tail = rings[i][s].head;
+        }
+
+        lane_t* l = &lanes[i];
+        // set queue (circular list) to empty
+        l->putIdx = 0;
+        l->getIdx = 0;
+
+        // zero out the event records
+        for ( int k = 0; k < l->size; k++ ) {
+            l->events[ k ].data.i  = 0;
+            l->events[ k ].handler = NULL;
+        }
+    }
+}
+
+// the producer is whatever context is running: thread mode, or an ISR
+// ISRs sharing a preempt priority can't interrupt each other, so they share a ring
+static event_src_t current_src( void )
+{
+    uint32_t ipsr = __get_IPSR();
+    if( ipsr == 0 ){ return EVENT_SRC_Main; }
+    if( ipsr < 16 ){ return EVENT_SRC_COUNT; } // system exception
+    switch( NVIC_GetPriority( (IRQn_Type)(ipsr - 16) ) ){
+        case DAC_IRQPriority: return EVENT_SRC_Audio;
+        case I2C_Priority:    return EVENT_SRC_I2C;
+        case TIM_IRQPriority: return EVENT_SRC_Timer;
+        default:              return EVENT_SRC_COUNT; // use a locked lane
+    }
+}
+
+static uint8_t ring_push( ring_t* r, event_t* e )
+{
+    uint16_t head  = r->head;
+    uint16_t depth = head - r->tail;
+    if( depth >= r->mask ){ // full
+        r->stats.dropped++;
+        return 0;
+    }
+    volatile event_t* slot = &r->events[ head & r->mask ];
+    slot->handler = e->handler;
+    slot->index   = e->index;
+    slot->data    = e->data;
+    __DMB(); // slot is written before it is published
+    r->head = head + 1;
+    r->stats.posted++;
+    if( depth + 1u > r->stats.peak ){ r->stats.peak = depth + 1; }
+    return 1;
+}
+
+// handler of the oldest pending event, or NULL
+static handler_fn ring_peek( ring_t* r )
+{
+    uint16_t tail = r->tail;
+    if( tail == r->head ){ return NULL; }
+    __DMB();
+    return r->events[ tail & r->mask ].handler;
+}
+
+static uint8_t ring_pop( ring_t* r, event_t* e )
+{
+    uint16_t tail = r->tail;
+    if( tail == r->head ){ return 0; } // empty
+    __DMB(); // head is read before the slot
+    r->tail = tail + 1; // claim before copying, so a coalescing producer skips it
+    volatile event_t* slot = &r->events[ tail & r->mask ];
+    e->handler = slot->handler;
+    e->index   = slot->index;
+    e->data    = slot->data;
+    return 1;
+}
 
-    // zero out the event records
-    for ( int k = 0; k < MAX_EVENTS; k++ ) {
-        sysEvents[ k ].data.i  = 0;
-        sysEvents[ k ].handler = NULL;
+// only safe where the producer preempts the consumer, ie. from an ISR or the main loop
+static uint8_t ring_coalesce( ring_t* r, event_t* e )
+{
+    uint16_t tail = r->tail;
+    for( uint16_t i = r->head; i != tail; i-- ){ // newest first
+        volatile event_t* p = &r->events[ (uint16_t)(i-1) & r->mask ];
+        if( p->handler == e->handler && p->index.i == e->index.i ){
+            p->data = e->data;
+            r->stats.coalesced++;
+            return 1;
+        }
     }
+    return 0;
 }
 
-// get next event
-// returns non-zero if an event was available
-void event_next( void ){
-    event_t* e = NULL;
+static uint8_t events_pending( void )
+{
+    for( int i=0; i<EVENT_LANE_COUNT; i++ ){
+        if( lanes[i].getIdx != lanes[i].putIdx ){ return 1; }
+        for( int s=0; s<EVENT_SRC_COUNT; s++ ){
+            if( rings[i][s].tail != rings[i][s].head ){ return 1; }
+        }
+    }
+    return 0;
+}
 
+static uint8_t lane_pop( lane_t* l, event_t* e )
+{
+    uint8_t found = 0;
+    if( l->getIdx == l->putIdx ){ return 0; } // skip the lock when empty
     BLOCK_IRQS(
         // if pointers are equal, the queue is empty... don't allow idx's to wrap!
-        if ( getIdx != putIdx ) {
-            INCR_EVENT_INDEX( getIdx );
-            e = (event_t*)&sysEvents[ getIdx ];
+        if ( l->getIdx != l->putIdx ) {
+            INCR_EVENT_INDEX( l, l->getIdx );
+            *e = *(event_t*)&l->events[ l->getIdx ]; // copy, as the slot is free to reuse
+            found = 1;
         }
     );
+    return found;
+}
 
-    if( e != NULL ){ (*e->handler)(e); } // call the event handler after enabling IRQs
+void events_set_batch( handler_fn handler, event_batch_fn batch )
+{
+    for( int i=0; i<batch_count; i++ ){
+        if( batches[i].handler == handler ){
+            batches[i].batch = batch;
+            return;
+        }
+    }
+    if( batch_count >= BATCH_KINDS ){
+        printf("no room for event batch\n");
+        return;
+    }
+    batches[batch_count++] = (batch_t){ .handler = handler, .batch = batch };
 }
 
+static event_batch_fn find_batch( handler_fn handler )
+{
+    for( int i=0; i<batch_count; i++ ){
+        if( batches[i].handler == handler ){ return batches[i].batch; }
+    }
+    return NULL;
+}
 
-// add event to queue, return success status
-uint8_t event_post( event_t *e ) {
+// take every ring's leading run of events for handler. order is kept per producer
+static int gather_batch( event_t* es, int count, int lane )
+{
+    for( int s=0; s<EVENT_SRC_COUNT; s++ ){
+        ring_t* r = &rings[lane][s];
+        while( count < EVENTS_BATCH_MAX && ring_peek(r) == es[0].handler ){
+            ring_pop( r, &es[count++] );
+        }
+    }
+    return count;
+}
+
+// get next event, from the highest priority lane that has one
+// producers in a lane take turns, so one busy context can't starve the others
+// returns the number of events handled
+uint8_t event_next( void ){
+    event_t es[ EVENTS_BATCH_MAX ];
+    uint8_t found = 0;
+    int lane = 0;
+
+    for( ; lane<EVENT_LANE_COUNT && !found; lane++ ){
+        for( int n=0; n<EVENT_SRC_COUNT && !found; n++ ){
+            int s = ring_next[lane];
+            if( ++ring_next[lane] >= EVENT_SRC_COUNT ){ ring_next[lane] = 0; }
+            found = ring_pop( &rings[lane][s], &es[0] );
+        }
+        if( !found ){ found = lane_pop( &lanes[lane], &es[0] ); }
+    }
+    if( !found ){ return 0; }
+    lane--; // undo the loop increment
+
+    event_batch_fn batch = find_batch( es[0].handler );
+    if( batch ){
+        found = gather_batch( es, 1, lane );
+        (*batch)( es, found );
+    } else {
+        (*es[0].handler)( &es[0] ); // call the event handler after enabling IRQs
+    }
+    return found;
+}
+
+// the budget is checked after each event, so a slow handler can run over it
+void event_drain( void ){
+    uint32_t start = DWT->CYCCNT;
+    uint32_t count = 0;
+    uint8_t n;
+    while( (n = event_next()) ){
+        count += n;
+        if( (DWT->CYCCNT - start) >= budget_cycles ){
+            if( budget_cycles && events_pending() ){ stats.overruns++; }
+            break;
+        }
+    }
+    if( count ){
+        stats.handled += count;
+        stats.last = count;
+        if( count > stats.peak ){ stats.peak = count; }
+    }
+}
+
+
+static void report_full( event_lane_t lane )
+{
+    printf("%s\n", lanes[lane].full_msg);
+    Caw_send_luachunk((char*)lanes[lane].full_msg);
+}
+
+// add event to a locked lane's queue, return success status
+static uint8_t lane_post( event_t *e, event_lane_t lane ) {
+    lane_t* l = &lanes[lane];
     uint8_t status = 0;
 
     BLOCK_IRQS(
         // increment write idx, posbily wrapping
-        int saveIndex = putIdx;
-        INCR_EVENT_INDEX( putIdx );
-        if ( putIdx != getIdx  ) {
-            sysEvents[ putIdx ].handler = e->handler;
-            sysEvents[ putIdx ].index   = e->index;
-            sysEvents[ putIdx ].data    = e->data;
+        int saveIndex = l->putIdx;
+        INCR_EVENT_INDEX( l, l->putIdx );
+        if ( l->putIdx != l->getIdx  ) {
+            l->events[ l->putIdx ].handler = e->handler;
+            l->events[ l->putIdx ].index   = e->index;
+            l->events[ l->putIdx ].data    = e->data;
             status = 1;
+            l->stats.posted++;
+            int depth = l->putIdx - l->getIdx;
+            if( depth < 0 ){ depth += l->size; }
+            if( depth > (int)l->stats.peak ){ l->stats.peak = depth; }
         } else {
             // idx wrapped, so queue is full, restore idx
-            putIdx = saveIndex;
+            l->putIdx = saveIndex;
+            l->stats.dropped++;
         }
     );
 
-    if( !status ){
-        printf("event queue full!\n");
-        Caw_send_luachunk("event queue full!");
-    }
+    return status;
+}
 
+// add event to a lane, return success status
+// known contexts post to their own ring without masking IRQs
+uint8_t event_post_lane( event_t *e, event_lane_t lane ) {
+    if( lane >= EVENT_LANE_COUNT ){ return 0; }
+    event_src_t src = current_src();
+    uint8_t status = (src < EVENT_SRC_COUNT) ? ring_push( &rings[lane][src], e )
+                                             : lane_post( e, lane );
+    if( !status ){ report_full( lane ); }
     return status;
 }
+
+void events_set_coalesce( uint8_t enable )
+{
+    coalesce = enable;
+}
+
+// continuous values: a pending event with the same handler & index is stale
+// so it is overwritten in place, rather than consuming another slot
+uint8_t event_post_latest( event_t *e, event_lane_t lane ) {
+    if( lane >= EVENT_LANE_COUNT ){ return 0; }
+    uint8_t found = 0;
+
+    if( coalesce ){
+        event_src_t src = current_src();
+        if( src < EVENT_SRC_COUNT ){
+            found = ring_coalesce( &rings[lane][src], e );
+        } else {
+            lane_t* l = &lanes[lane];
+            BLOCK_IRQS(
+                // newest first, as a repeat is most likely near the write idx
+                for( int i = l->putIdx; i != l->getIdx; i = (i ? i : l->size) - 1 ){
+                    volatile event_t* p = &l->events[ i ];
+                    if( p->handler == e->handler && p->index.i == e->index.i ){
+                        p->data = e->data;
+                        l->stats.coalesced++;
+                        found = 1;
+                        break;
+                    }
+                }
+            );
+        }
+    }
+
+    return found ? 1 : event_post_lane( e, lane );
+}
+
+uint8_t event_post( event_t *e ) {
+    return event_post_lane( e, EVENT_LANE_Timing );
+}
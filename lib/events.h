@@ -2,6 +2,8 @@
 
 #include <stdint.h>
 
+#define EVENTS_BUDGET_US 500 // default time event_drain() may spend per call
+
 union Data{
     void* p;
     int i;
@@ -15,7 +17,51 @@ typedef struct event{
     union Data   data;
 } event_t;
 
+// dispatch prefers the timing lane. each lane has its own capacity
+typedef enum{ EVENT_LANE_Timing // clock, metro, asl done, change, etc
+            , EVENT_LANE_Bulk   // stream, volume, freq, ii rx
+            , EVENT_LANE_COUNT
+} event_lane_t;
+
+// producing contexts, each with its own lock-free ring per lane
+// ISRs are identified by their preempt priority. see ll/interrupts.h
+typedef enum{ EVENT_SRC_Main  // thread mode, ie. the main loop & lua
+            , EVENT_SRC_Audio // DAC block ISR: io, detect, slopes
+            , EVENT_SRC_I2C
+            , EVENT_SRC_Timer // metros
+            , EVENT_SRC_COUNT // other contexts use a locked queue
+} event_src_t;
+
+typedef struct{
+    uint32_t posted;
+    uint32_t dropped; // lane was full
+    uint32_t peak;    // most events queued at once
+    uint32_t coalesced; // stale events replaced by event_post_latest
+} event_lane_stats_t;
+
 extern void events_init(void);
 extern void events_clear(void);
-extern uint8_t event_post(event_t *e);
-extern void event_next( void );
+extern uint8_t event_post(event_t *e); // timing lane
+extern uint8_t event_post_lane(event_t *e, event_lane_t lane);
+extern uint8_t event_post_latest(event_t *e, event_lane_t lane); // latest value wins
+extern void events_set_coalesce( uint8_t enable ); // 0 makes post_latest a plain post
+extern uint8_t event_next( void ); // returns count of events handled
+
+// a batch handler receives a burst of pending events that share a handler
+#define EVENTS_BATCH_MAX 16
+typedef void (*event_batch_fn)( event_t* es, int count );
+extern void events_set_batch( void (*handler)( event_t* e ), event_batch_fn batch );
+
+// run events until the queue is empty or the budget runs out. a budget of 0 runs one event
+extern void event_drain( void );
+extern void events_set_budget( uint32_t microseconds );
+
+typedef struct{
+    uint32_t handled;  // total events run by event_drain
+    uint32_t last;     // events run by the most recent non-empty drain
+    uint32_t peak;     // most events run in a single drain
+    uint32_t overruns; // drains that ran out of budget with events still queued
+} event_stats_t;
+
+extern event_stats_t events_get_stats( void );
+extern event_lane_stats_t events_get_lane_stats( event_lane_t lane );
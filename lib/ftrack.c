@@ -1,16 +1,15 @@
 #include "ftrack.h"
 
-#include "ll/adda.h" // ADDA_BLOCK_SIZE
-
 // time constant
 #define FTRACK_SMOOTHING 0.1 // ~60 samples of settling time (freq dependent)
 //#define FTRACK_SLEW      0.013 // 500 blocks == 333ms
 #define FTRACK_SLEW      0.013 // 500 blocks == 333ms
     // reducing this value does not increase accuracy substantially 
-// crow is fixed at 48kHz sample rate
-#define FTRACK_SAMPLERATE (48000/ADDA_BLOCK_SIZE)
+#define FTRACK_SLEW_RATE 1500.0 // block rate at which FTRACK_SLEW is specified
 
 // globals
+static float samplerate; // rate of FTrack_get() calls
+static float slew;
 static int blocks;
 static int zc;
 static float last;
@@ -42,9 +41,12 @@ void FTrack_deinit( void )
 ////////////////////////////////
 // Configuration
 
-void FTrack_start( void )
+void FTrack_start( float block_rate )
 {
     // reset parameters
+    samplerate = block_rate;
+    slew       = FTRACK_SLEW * FTRACK_SLEW_RATE / block_rate; // keep 333ms at any rate
+    if( slew > 1.0 ){ slew = 1.0; }
     blocks = 0;
     zc     = 0;
     last   = 0.0;
@@ -67,7 +69,7 @@ float FTrack_get( void )
     blocks++;
     if( zc > 0 ){ // new zero-crossings this frame
         // apply LP1 relative to input freq rate
-        float dest = FTRACK_SAMPLERATE * (float)zc / (float)blocks;
+        float dest = samplerate * (float)zc / (float)blocks;
         last = last + FTRACK_SMOOTHING * (dest-last);
 
         // reset counters
@@ -75,8 +77,8 @@ float FTrack_get( void )
         zc     = 0;
     }
     // signal rate slews. 2xLP1
-    z  = z  + FTRACK_SLEW * (last- z );
-    zz = zz + FTRACK_SLEW * (z   - zz);
+    z  = z  + slew * (last- z );
+    zz = zz + slew * (z   - zz);
     return zz;
 }
 
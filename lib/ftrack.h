@@ -17,7 +17,7 @@
 void FTrack_init( void );
 void FTrack_deinit( void );
 
-void FTrack_start( void );
+void FTrack_start( float block_rate ); // FTrack_get() is called at block_rate
 void FTrack_stop( void );
 
 float FTrack_get( void );
@@ -10,25 +10,59 @@
 #include "metro.h"
 #include "caw.h"
 #include "casl.h"
+#include "clock.h"             // clock_block()
 
 #include "lualink.h"           // L_handle_in_stream (pass this in as ptr?)
 
 #define IN_CHANNELS ADDA_ADC_CHAN_COUNT
 
+#define PUBLIC_INTERVAL 0.0107 // seconds between public view param updates
+
 static void public_update( void );
+static int public_blocks = 16;
+
+// virtual slopes are rendered to vbuf, then summed into outputs by level
+static float vbuf[SLOPE_VIRTUALS][ADDA_BLOCK_SIZE_MAX];
+static float vmix[SLOPE_OUTPUTS][SLOPE_VIRTUALS];
+static uint32_t virtual_cycles = 0; // smoothed cost per virtual slope, per block
+
+static void virtual_mix( float* out, const float* levels, int size );
 
-void IO_Init( int adc_timer_ix )
+// time base shared by clock, metro & slopes. samples since IO_Start
+static volatile uint64_t sample_time = 0; // at the start of the current block
+static volatile uint32_t block_cycles = 0; // DWT count at the start of the current block
+static float  io_sample_rate = ADDA_SAMPLE_RATE;
+static double block_seconds;
+
+void IO_Init( int adc_timer_ix, int sample_rate, int block_size )
 {
-    // hardware layer
-    ADDA_Init(adc_timer_ix);
+    // hardware layer. may reject the requested config
+    block_size  = ADDA_Init( adc_timer_ix, sample_rate, block_size );
+    sample_rate = ADDA_GetSampleRate();
+    float block_rate = (float)sample_rate / (float)block_size;
+    io_sample_rate = (float)sample_rate;
+    block_seconds  = (double)block_size / (double)sample_rate;
 
     // dsp objects
-    Detect_init( IN_CHANNELS );
+    Detect_init( IN_CHANNELS, block_rate );
+    S_init( SLOPE_CHANNELS, sample_rate ); // before casl registers its refill
     for(int i=0; i<SLOPE_CHANNELS; i++){
         casl_init(i);
     }
-    S_init( SLOPE_CHANNELS );
-    AShaper_init( SLOPE_CHANNELS );
+    AShaper_init( SLOPE_OUTPUTS );
+    for( int j=0; j<SLOPE_OUTPUTS; j++ ){
+        for( int k=0; k<SLOPE_VIRTUALS; k++ ){
+            vmix[j][k] = 0.0;
+        }
+    }
+
+    // enable the cycle counter for profiling virtual slopes
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+
+    public_blocks = (int)(PUBLIC_INTERVAL * block_rate);
+    if( public_blocks < 1 ){ public_blocks = 1; }
 }
 
 void IO_Start( void )
@@ -39,17 +73,36 @@ void IO_Start( void )
 // DSP process
 IO_block_t* IO_BlockProcess( IO_block_t* b )
 {
+    block_cycles = DWT->CYCCNT;
+    sample_time += b->size;
+    // schedulers first, so input handlers see this block's time
+    clock_block();
+    Metro_block();
     for( int j=0; j<IN_CHANNELS; j++ ){
         Detect_t* d = Detect_ix_to_p(j);
         (*d->modefn)( d, b->in[j][b->size-1] );
     }
-    for( int j=0; j<SLOPE_CHANNELS; j++ ){
+    for( int j=0; j<SLOPE_OUTPUTS; j++ ){
         S_step_v( j
                 , b->out[j]
                 , b->size
                 );
     }
-    for( int j=0; j<SLOPE_CHANNELS; j++ ){
+
+    uint32_t vstart = DWT->CYCCNT;
+    for( int j=0; j<SLOPE_VIRTUALS; j++ ){
+        S_step_v( SLOPE_OUTPUTS + j
+                , vbuf[j]
+                , b->size
+                );
+    }
+    for( int j=0; j<SLOPE_OUTPUTS; j++ ){ // mix before quantization
+        virtual_mix( b->out[j], vmix[j], b->size );
+    }
+    uint32_t vcost = (DWT->CYCCNT - vstart) / SLOPE_VIRTUALS;
+    virtual_cycles = (virtual_cycles * 15 + vcost) >> 4;
+
+    for( int j=0; j<SLOPE_OUTPUTS; j++ ){
         AShaper_v( j
                  , b->out[j]
                  , b->size
@@ -58,6 +111,56 @@ IO_block_t* IO_BlockProcess( IO_block_t* b )
     public_update();
     return b;
 }
+
+static void virtual_mix( float* out, const float* levels, int size )
+{
+    for( int k=0; k<SLOPE_VIRTUALS; k++ ){
+        float level = levels[k];
+        if( level == 0.0 ){ continue; } // unrouted
+        const float* v = vbuf[k];
+        for( int i=0; i<size; i++ ){
+            out[i] += level * v[i];
+        }
+    }
+}
+
+void IO_SetVirtualMix( int output, int virtual, float level )
+{
+    if( output < 0 || output >= SLOPE_OUTPUTS ){ return; }
+    if( virtual < 0 || virtual >= SLOPE_VIRTUALS ){ return; }
+    vmix[output][virtual] = level;
+}
+
+uint32_t IO_GetVirtualCycles( void )
+{
+    return virtual_cycles;
+}
+
+uint64_t IO_GetSampleTime( void )
+{
+    uint64_t t;
+    BLOCK_IRQS( t = sample_time; ); // 64bit read isn't atomic
+    return t;
+}
+
+double IO_GetSampleTimePrecise( void )
+{
+    uint64_t samples;
+    uint32_t cycles;
+    BLOCK_IRQS(
+        samples = sample_time;
+        cycles  = block_cycles;
+    );
+    double since = (double)(DWT->CYCCNT - cycles) / (double)SystemCoreClock;
+    if( since > block_seconds ){ since = block_seconds; } // ISR is late. stay monotonic
+    return (double)samples + since * (double)io_sample_rate;
+}
+
+float IO_GetSampleRate( void )
+{
+    return io_sample_rate;
+}
+
 float IO_GetADC( uint8_t channel )
 {
     return ADDA_GetADCValue( channel );
@@ -120,7 +223,7 @@ static void public_update( void )
     static int bcount = 0;
     static int chan = 0; // outputs*4 then inputs*2
     bcount++;
-    if(bcount >= 16){ // time to send a new update
+    if(bcount >= public_blocks){ // time to send a new update
         bcount = 0;
         if(view_chans[chan]){
             if(chan<4){ // outputs
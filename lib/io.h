@@ -3,11 +3,22 @@
 #include <stm32f7xx.h>
 #include <stdbool.h>
 
-void IO_Init( int adc_timer_ix );
+#include "../ll/adda.h" // ADDA_SAMPLE_RATE, ADDA_BLOCK_SIZE
+
+void IO_Init( int adc_timer_ix, int sample_rate, int block_size );
 void IO_Start( void );
 
 void IO_Process( void );
 
+// virtual slopes. indices are 0-based within outputs / virtuals
+void IO_SetVirtualMix( int output, int virtual, float level );
+uint32_t IO_GetVirtualCycles( void ); // cpu cycles per virtual slope per block
+
+// monotonic sample counter, advanced by IO_BlockProcess
+uint64_t IO_GetSampleTime( void ); // samples at the start of the current block
+double IO_GetSampleTimePrecise( void ); // interpolated within the block by the cycle counter
+float IO_GetSampleRate( void );
+
 float IO_GetADC( uint8_t channel );
 void IO_SetADCaction( uint8_t channel, const char* mode );
 
@@ -4,17 +4,23 @@
 #include <stdlib.h>            // malloc()
 #include <stdio.h>
 
-#include "../ll/timers.h"      // _Init() _Start() _Stop() _Set_Params()
+#include "io.h"               // IO_GetSampleTime() IO_GetSampleRate()
 #include "lualink.h"           // L_handle_metro()
 
 typedef enum { METRO_STATUS_RUNNING
              , METRO_STATUS_STOPPED
 } M_STATUS_t;
 
+// metros are scheduled on the IO sample counter, so they stay in phase with clock & slopes
+// the period is whole samples plus a 32bit fraction, so repeats don't drift
 typedef struct{
     int        ix;       // TODO never used. metro index
-    M_STATUS_t status;   // running/stopped status
-    float      seconds;  // TODO never used. period in seconds
+    volatile M_STATUS_t status; // running/stopped status
+    float      seconds;  // period in seconds
+    uint32_t   period;   // whole samples
+    uint32_t   frac;     // fractional sample, in 1/2^32ths
+    uint32_t   acc;      // accumulated fraction
+    uint64_t   next;     // sample time of the next bang
     int32_t    count;    // number of repeats. <0 is infinite
     int32_t    stage;    // number of repeateds.
 } Metro_t;
@@ -25,19 +31,28 @@ Metro_t* metros;
 static void Metro_bang( int ix );
 
 // public definitions
-int max_num_metros = 0;
+const int MAX_NUM_METROS = 8; // matches Metro.num_metros in lua/metro.lua
+
+static volatile int max_num_metros = 0; // set once allocated. Metro_block runs from the audio ISR
 void Metro_Init( int num_metros )
 {
-    max_num_metros = num_metros;
-    metros = malloc( sizeof(Metro_t) * max_num_metros );
-
-    for( int i=0; i<max_num_metros; i++ ){
-        metros[i].ix      = i;
-        metros[i].status  = METRO_STATUS_STOPPED;
-        metros[i].seconds = 1.0;
-        metros[i].count   = -1;
-        metros[i].stage   = 0;
+    Metro_t* ms = malloc( sizeof(Metro_t) * num_metros );
+    if( !ms ){ printf("metros malloc failed\n"); return; }
+
+    for( int i=0; i<num_metros; i++ ){
+        ms[i].ix      = i;
+        ms[i].status  = METRO_STATUS_STOPPED;
+        ms[i].seconds = 1.0;
+        ms[i].period  = (uint32_t)IO_GetSampleRate();
+        ms[i].frac    = 0;
+        ms[i].acc     = 0;
+        ms[i].next    = 0;
+        ms[i].count   = -1;
+        ms[i].stage   = 0;
     }
+    metros = ms;
+    __DMB(); // metros are ready before the ISR can see them
+    max_num_metros = num_metros;
 }
 
 void Metro_start( int ix )
@@ -46,8 +61,11 @@ void Metro_start( int ix )
      || ix >= max_num_metros ){ printf("metro_start: bad index\n"); return; }
 
     Metro_t* t = &(metros[ix]);
-    t->status = METRO_STATUS_RUNNING;
-    Timer_Start( ix, Metro_bang );
+    BLOCK_IRQS(
+        t->acc    = 0;
+        t->next   = IO_GetSampleTime() + t->period; // first bang after 1 period
+        t->status = METRO_STATUS_RUNNING;
+    );
 }
 
 void Metro_stop( int ix )
@@ -56,10 +74,7 @@ void Metro_stop( int ix )
      || ix >= max_num_metros ){ printf("metro_stop: bad index\n"); return; }
 
     Metro_t* t = &(metros[ix]);
-    if( t->status == METRO_STATUS_RUNNING ){
-        t->status = METRO_STATUS_STOPPED;
-        Timer_Stop( ix );
-    }
+    t->status = METRO_STATUS_STOPPED;
 }
 
 void Metro_stop_all( void )
@@ -74,7 +89,33 @@ void Metro_set_time( int ix, float sec )
     if( ix < 0
      || ix >= max_num_metros ){ printf("metro_set_time: bad index\n"); return; }
 
-    Timer_Set_Params( ix, sec ); // only using struct accessor
+    Metro_t* t = &(metros[ix]);
+    double samps = (double)sec * (double)IO_GetSampleRate();
+    if( samps < (double)1.0 ){ samps = 1.0; } // at most one bang per sample
+    uint32_t whole = (uint32_t)samps;
+    uint32_t frac  = (uint32_t)( (samps - (double)whole) * (double)0x100000000 );
+    BLOCK_IRQS( // period is read by Metro_block
+        t->seconds = sec;
+        t->period  = whole;
+        t->frac    = frac;
+    );
+}
+
+// called from the audio ISR at the start of each block
+// a period shorter than a block bangs more than once in that block
+void Metro_block( void )
+{
+    uint64_t now = IO_GetSampleTime();
+    for( int i=0; i<max_num_metros; i++ ){
+        Metro_t* t = &(metros[i]);
+        while( t->status == METRO_STATUS_RUNNING && t->next <= now ){
+            t->next += t->period;
+            uint32_t acc = t->acc + t->frac;
+            if( acc < t->acc ){ t->next++; } // fraction wrapped into a whole sample
+            t->acc = acc;
+            Metro_bang(i);
+        }
+    }
 }
 
 void Metro_set_count( int ix, int count )
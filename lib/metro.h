@@ -13,3 +13,5 @@ void Metro_stop_all( void );
 void Metro_set_time( int ix, float sec );
 void Metro_set_count( int ix, int count );
 void Metro_set_stage( int ix, int stage );
+
+void Metro_block( void ); // audio ISR: bang metros that are due
@@ -5,6 +5,12 @@
 
 #include "submodules/wrDsp/wrBlocks.h" // for vectorized shapers
 
+// sin, log & exp use interpolated tables unless built with SHAPES_LIBM
+// the libm path is kept as the reference for accuracy checks
+#ifndef SHAPES_LIBM
+#include "build/shapes_lut.h" // generated by util/shapes_lut.lua
+#endif
+
 //////////////////////////////
 // single sample shapers
 // all operate over a range of (0,1)
@@ -12,6 +18,8 @@
 #define M_PI   (3.141592653589793) // 64bit compatible
 #define M_PI_2 (M_PI/2.0)
 
+#ifdef SHAPES_LIBM
+
 // shapers normalized (0,1). from:
 // http://probesys.blogspot.com/2011/10/useful-math-functions.html
 
@@ -30,6 +38,37 @@ float shapes_log( float in )
     return 1.0 - powf(2.0, -10.0 * in);
 }
 
+#else // lookup tables
+
+// linear interpolation into a table spanning [0,1]. input is clamped
+static inline float lut( const float* t, float in )
+{
+    float fix = in * (float)SHAPES_LUT_SIZE;
+    if( fix <= 0.0 ){ return t[0]; }
+    if( fix >= (float)SHAPES_LUT_SIZE ){ return t[SHAPES_LUT_SIZE]; }
+    int ix = (int)fix;
+    float c = fix - (float)ix;
+    return t[ix] + c * (t[ix+1] - t[ix]);
+}
+
+float shapes_sin( float in )
+{
+    return lut( shapes_lut_sin, in );
+}
+
+float shapes_exp( float in )
+{
+    return lut( shapes_lut_exp, in );
+}
+
+// log is exp rotated by 180deg
+float shapes_log( float in )
+{
+    return 1.0f - lut( shapes_lut_exp, 1.0f - in );
+}
+
+#endif // SHAPES_LIBM
+
 float shapes_step_now( float in )
 {
     return 1.0;
@@ -72,6 +111,8 @@ float shapes_ease_out_rebound( float in )
 ////////////////////////////////
 // vectorized shapers
 
+#ifdef SHAPES_LIBM
+
 float* shapes_v_sin( float* in, int size )
 {
     return b_mul(
@@ -106,3 +147,95 @@ float* shapes_v_log( float* in, int size )
                 , 1.0
                 , size );
 }
+
+#else // lookup tables
+
+float* shapes_v_sin( float* in, int size )
+{
+    float* in2 = in;
+    for( int i=0; i<size; i++ ){
+        *in2 = lut( shapes_lut_sin, *in2 );
+        in2++;
+    }
+    return in;
+}
+
+float* shapes_v_exp( float* in, int size )
+{
+    float* in2 = in;
+    for( int i=0; i<size; i++ ){
+        *in2 = lut( shapes_lut_exp, *in2 );
+        in2++;
+    }
+    return in;
+}
+
+float* shapes_v_log( float* in, int size )
+{
+    float* in2 = in;
+    for( int i=0; i<size; i++ ){
+        *in2 = 1.0f - lut( shapes_lut_exp, 1.0f - *in2 );
+        in2++;
+    }
+    return in;
+}
+
+#endif // SHAPES_LIBM
+
+float* shapes_v_step_now( float* in, int size )
+{
+    float* in2 = in;
+    for( int i=0; i<size; i++ ){
+        *in2++ = 1.0;
+    }
+    return in;
+}
+
+float* shapes_v_step_wait( float* in, int size )
+{
+    float* in2 = in;
+    for( int i=0; i<size; i++ ){
+        *in2 = (*in2 < 0.99999) ? 0.0 : 1.0;
+        in2++;
+    }
+    return in;
+}
+
+float* shapes_v_ease_in_back( float* in, int size )
+{
+    float* in2 = in;
+    for( int i=0; i<size; i++ ){
+        float x = *in2;
+        *in2++ = x * x * (2.70158 * x - 1.70158);
+    }
+    return in;
+}
+
+float* shapes_v_ease_out_back( float* in, int size )
+{
+    float* in2 = in;
+    for( int i=0; i<size; i++ ){
+        float in_1 = *in2 - 1.0;
+        *in2++ = in_1 * in_1 * (2.70158 * in_1 + 1.70158) + 1.0;
+    }
+    return in;
+}
+
+// each bounce is the same parabola, so select the segment's offset & floor
+// then apply one shared polynomial (no per-sample function call)
+float* shapes_v_ease_out_rebound( float* in, int size )
+{
+    float* in2 = in;
+    for( int i=0; i<size; i++ ){
+        float x = *in2;
+        float off, base;
+        if( x < (1.0/2.75) ){        off = 0.0;        base = 0.0;
+        } else if( x < (2.0/2.75) ){ off = 1.5/2.75;   base = 0.75;
+        } else if( x < (2.5/2.75) ){ off = 2.25/2.75;  base = 0.9375;
+        } else {                     off = 2.625/2.75; base = 0.984375;
+        }
+        x -= off;
+        *in2++ = 7.5625 * x * x + base;
+    }
+    return in;
+}
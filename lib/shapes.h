@@ -12,3 +12,8 @@ float shapes_ease_out_rebound( float in );
 float* shapes_v_sin( float* in, int size );
 float* shapes_v_log( float* in, int size );
 float* shapes_v_exp( float* in, int size );
+float* shapes_v_step_now( float* in, int size );
+float* shapes_v_step_wait( float* in, int size );
+float* shapes_v_ease_in_back( float* in, int size );
+float* shapes_v_ease_out_back( float* in, int size );
+float* shapes_v_ease_out_rebound( float* in, int size );
@@ -15,6 +15,7 @@
 
 static uint8_t slope_count = 0;
 static Slope_t* slopes = NULL;
+static float samples_per_ms = 48.0;
 
 
 ////////////////////////////////
@@ -25,6 +26,13 @@ static float* step_v( Slope_t* self, float* out, int size );
 static float* static_v( Slope_t* self, float* out, int size );
 static float* motion_v( Slope_t* self, float* out, int size );
 static float* breakpoint_v( Slope_t* self, float* out, int size );
+static float breakpoint( Slope_t* self );
+static float breakpoint_action( Slope_t* self );
+static bool queue_pop( Slope_t* self );
+
+static float* fixed_step_v( Slope_t* self, float* out, int size );
+static float* fixed_static_v( Slope_t* self, float* out, int size );
+static float* fixed_motion_v( Slope_t* self, float* out, int size );
 
 static float* shaper_v( Slope_t* self, float* out, int size );
 static float shaper( Slope_t* self, float out );
@@ -32,8 +40,9 @@ static float shaper( Slope_t* self, float out );
 ////////////////////////////////
 // public definitions
 
-void S_init( int channels )
+void S_init( int channels, int sample_rate )
 {
+    samples_per_ms = (float)sample_rate / 1000.0;
     slope_count = channels;
     slopes = malloc( sizeof( Slope_t ) * channels );
     if( !slopes ){ printf("slopes malloc failed\n"); return; }
@@ -48,9 +57,57 @@ void S_init( int channels )
         slopes[j].delta  = 0.0;
         slopes[j].countdown = -1.0;
         slopes[j].scale = 0.0;
+
+        slopes[j].mode   = SLOPE_Float;
+        slopes[j].phase  = SLOPE_PHASE_ONE;
+        slopes[j].inc    = 0;
+        slopes[j].rem    = 0;
+        slopes[j].err    = 0;
+        slopes[j].length = 1;
+        slopes[j].count  = 0;
+        slopes[j].carry  = 0.0;
+
+        slopes[j].q_read  = 0;
+        slopes[j].q_write = 0;
+        slopes[j].refill  = NULL;
     }
 }
 
+// switching mid-segment converts the running state, so the slope continues
+void S_set_mode( int index, SlopeMode_t mode )
+{
+    if( index < 0 || index >= SLOPE_CHANNELS ){ return; }
+    Slope_t* self = &slopes[index]; // safe pointer
+
+    if( mode == self->mode ){ return; }
+    BLOCK_IRQS( // the ISR renders from this state
+        if( mode == SLOPE_Fixed ){
+            self->phase = (self->here >= 1.0) ? SLOPE_PHASE_ONE
+                        : (self->here <= 0.0) ? 0
+                        : (uint32_t)(self->here * (float)SLOPE_PHASE_ONE);
+            self->count = (self->countdown > 0.0) ? (uint32_t)ceilf(self->countdown) : 0;
+            if( self->count ){
+                uint32_t togo = SLOPE_PHASE_ONE - self->phase;
+                self->length = self->count;
+                self->inc    = togo / self->count;
+                self->rem    = togo % self->count;
+            }
+            self->err   = 0;
+            self->carry = 0.0;
+        } else {
+            self->here = (float)self->phase / (float)SLOPE_PHASE_ONE;
+            if( self->count ){
+                self->countdown = (float)self->count;
+                self->delta     = (1.0 - self->here) / self->countdown;
+            } else {
+                self->countdown = -1024.0; // at destination, without overflow
+                self->delta     = 0.0;
+            }
+        }
+        self->mode = mode;
+    );
+}
+
 Shape_t S_str_to_shape( const char* s )
 {
     char ps = (char)*s;
@@ -68,6 +125,62 @@ Shape_t S_str_to_shape( const char* s )
     }
 }
 
+////////////////////////////////
+// segment queue
+
+bool S_queue_push( int index, float destination, float ms, Shape_t shape )
+{
+    if( index < 0 || index >= SLOPE_CHANNELS ){ return false; }
+    Slope_t* self = &slopes[index]; // safe pointer
+
+    if( (uint8_t)(self->q_write - self->q_read) >= SLOPE_QUEUE_LEN ){ return false; }
+    SlopeSeg_t* s = &self->queue[self->q_write & SLOPE_QUEUE_MASK];
+    s->dest  = destination;
+    s->ms    = ms;
+    s->shape = shape;
+    __DMB(); // slot is written before it is published
+    self->q_write++;
+    return true;
+}
+
+void S_queue_clear( int index )
+{
+    if( index < 0 || index >= SLOPE_CHANNELS ){ return; }
+    Slope_t* self = &slopes[index]; // safe pointer
+
+    BLOCK_IRQS(
+        self->q_read = self->q_write;
+    );
+}
+
+int S_queue_space( int index )
+{
+    if( index < 0 || index >= SLOPE_CHANNELS ){ return 0; }
+    Slope_t* self = &slopes[index]; // safe pointer
+    return SLOPE_QUEUE_LEN - (uint8_t)(self->q_write - self->q_read);
+}
+
+float S_queue_lead( int index )
+{
+    if( index < 0 || index >= SLOPE_CHANNELS ){ return 0.0; }
+    Slope_t* self = &slopes[index]; // safe pointer
+
+    float samps = (self->mode == SLOPE_Fixed) ? (float)self->count
+                : (self->countdown > 0.0)     ? self->countdown
+                                              : 0.0;
+    float ms = samps / samples_per_ms;
+    for( uint8_t i=self->q_read; i!=self->q_write; i++ ){
+        ms += self->queue[i & SLOPE_QUEUE_MASK].ms;
+    }
+    return ms;
+}
+
+void S_set_refill( int index, Callback_t cb )
+{
+    if( index < 0 || index >= SLOPE_CHANNELS ){ return; }
+    slopes[index].refill = cb;
+}
+
 float S_get_state( int index )
 {
     if( index < 0 || index >= SLOPE_CHANNELS ){ return 0.0; }
@@ -101,6 +214,26 @@ void S_toward( int        index
             // only happens when assynchronously updating S_toward
             self->countdown = -0.0; // inactive.
         }
+        self->phase     = SLOPE_PHASE_ONE;
+        self->count     = 0;
+        self->carry     = 0.0; // timeline restarts here
+    } else if( self->mode == SLOPE_Fixed ){
+        self->last   = self->shaped;
+        self->scale  = self->dest - self->last;
+        if( self->count > 0 ){ self->carry = 0.0; } // retargeted mid-segment
+        // whole samples in this segment. fraction is carried so sequences don't drift
+        // double as a multi-minute segment exceeds float's integer precision
+        double samps = (double)ms * (double)samples_per_ms + (double)self->carry;
+        uint32_t n = (uint32_t)samps;
+        if( n < 1 ){ n = 1; }
+        self->carry  = (float)(samps - (double)n);
+        self->length = n;
+        self->count  = n;
+        self->inc    = SLOPE_PHASE_ONE / n;
+        self->rem    = SLOPE_PHASE_ONE % n;
+        self->err    = 0;
+        self->phase  = 0;
+        self->here   = 0.0;
     } else {
         // save current output level as new starting point
         self->last   = self->shaped;
@@ -109,7 +242,7 @@ void S_toward( int        index
         if( self->countdown < 0.0 && self->countdown > -1023.0 ){
             overflow = -(self->countdown);
         }
-        self->countdown = ms * SAMPLES_PER_MS; // samples until callback
+        self->countdown = ms * samples_per_ms; // samples until callback
         self->delta     = 1.0 / self->countdown;
         self->here      = 0.0; // start of slope
         if( overflow > 0.0 ){
@@ -146,7 +279,9 @@ static float* step_v( Slope_t* self
                     , int      size
                     )
 {
-    if( self->countdown <= 0.0 ){ // at destination
+    if( self->mode == SLOPE_Fixed ){
+        fixed_step_v( self, out, size );
+    } else if( self->countdown <= 0.0 ){ // at destination
         static_v( self, out, size );
     } else if( self->countdown > (float)size ){ // no edge case
         motion_v( self, out, size );
@@ -188,43 +323,150 @@ static float* motion_v( Slope_t* self, float* out, int size )
     return shaper_v( self, out, size );
 }
 
+// split the block at each breakpoint. segments between breakpoints use the
+// vector paths, and only the breakpoint sample itself is computed alone.
+// iterative (not recursive) so many breakpoints per block don't grow the stack
 static float* breakpoint_v( Slope_t* self, float* out, int size )
 {
-    if( size <= 0 ){ return out; }
-
-    self->here += self->delta; // no collision can happen on first samp
+    float* seg = out;
+    while( size > 0 ){
+        if( self->countdown <= 0.0 ){ // at destination
+            static_v( self, seg, size );
+            break;
+        } else if( self->countdown > (float)size ){ // no more breakpoints
+            motion_v( self, seg, size );
+            break;
+        }
+        // samples before the breakpoint
+        int pre = (int)ceilf( self->countdown ) - 1;
+        if( pre > 0 ){
+            motion_v( self, seg, pre );
+            seg  += pre;
+            size -= pre;
+        }
+        *seg++ = breakpoint( self );
+        size--;
+    }
+    return out;
+}
 
+// the single sample on which the countdown expires
+static float breakpoint( Slope_t* self )
+{
+    self->here += self->delta;
     self->countdown -= 1.0;
-    if( self->countdown <= 0.0 ){
-        // TODO unroll overshoot and apply proportionally to the post-*act sample
-        self->here = 1.0; // clamp for overshoot
-        if( self->action != NULL ){
-            Callback_t act = self->action;
-            self->action = NULL;
-            self->shaped = self->dest; // save real destination into shaped to actually reach it
-            (*act)(self->index);
-            // side-affects: self->{dest, shape, action, countdown, delta, (here)}
+    if( self->countdown > 0.0 ){ // float rounding left a partial sample
+        return shaper( self, self->here );
+    }
+    return breakpoint_action( self );
+}
+
+// destination reached. run the callback & return the breakpoint sample
+static float breakpoint_action( Slope_t* self )
+{
+    // TODO unroll overshoot and apply proportionally to the post-*act sample
+    self->here = 1.0; // clamp for overshoot
+    if( queue_pop( self ) ){ // pre-resolved segment is in motion
+        return shaper( self, self->here );
+    }
+    if( self->action != NULL ){
+        Callback_t act = self->action;
+        self->action = NULL;
+        self->shaped = self->dest; // save real destination into shaped to actually reach it
+        (*act)(self->index);
+        // side-affects: self->{dest, shape, action, countdown, delta, (here)}
+    }
+    if( self->action == NULL ){ // slope complete, or queued response
+        self->here  = 1.0;
+        self->delta = 0.0;
+        self->carry = 0.0; // at rest. the next segment starts on its own timeline
+    } // else instant callback. new slope continues from the next sample
+    return shaper( self, self->here );
+}
+
+
+// apply queued segments until one is in motion (returns true) or the queue is empty
+static bool queue_pop( Slope_t* self )
+{
+    if( self->q_read == self->q_write ){ return false; }
+
+    float ms = 0.0;
+    while( ms <= 0.0 && self->q_read != self->q_write ){
+        __DMB(); // q_write is read before the slot
+        SlopeSeg_t* s = &self->queue[self->q_read & SLOPE_QUEUE_MASK];
+        ms = s->ms;
+        self->shaped = self->dest; // save real destination into shaped to actually reach it
+        S_toward( self->index, s->dest, ms, s->shape, self->action );
+        __DMB(); // slot is consumed before it is released
+        self->q_read++;
+    }
+    if( self->refill != NULL ){ (*self->refill)(self->index); }
+    return (ms > 0.0);
+}
+
+
+///////////////////////////////
+// fixed-point segments
+// timing is an integer sample count, so breakpoints land exactly
+// the remainder of the phase increment is spread Bresenham-style,
+// so the phase is exactly SLOPE_PHASE_ONE on the final sample
+
+#define PHASE_TO_F (1.0/2147483648.0) // 1/SLOPE_PHASE_ONE
+
+static float* fixed_step_v( Slope_t* self, float* out, int size )
+{
+    float* seg = out;
+    while( size > 0 ){
+        if( self->count == 0 ){ // at destination
+            fixed_static_v( self, seg, size );
+            break;
+        } else if( self->count > (uint32_t)size ){ // no more breakpoints
+            fixed_motion_v( self, seg, size );
+            break;
         }
-        if( self->action != NULL ){ // instant callback
-            *out++ = shaper( self, self->here );
-            // 1. unwind self->countdown (ADD it to countdown)
-            // 2. recalc current sample with new slope
-            // 3. below call should be on out[0] and size
-            if(size > 1){
-                return step_v( self, out, size-1 );
-            } else { // handle breakpoint on last sample of frame
-                return out;
-            }
-        } else { // slope complete, or queued response
-            self->here  = 1.0;
-            self->delta = 0.0;
-            *out++ = shaper( self, self->here );
-            return static_v( self, out, size-1 );
+        int pre = self->count - 1;
+        if( pre > 0 ){
+            fixed_motion_v( self, seg, pre );
+            seg  += pre;
+            size -= pre;
         }
-    } else {
-        *out++ = shaper( self, self->here );
-        return breakpoint_v( self, out, size-1 ); // recursive call
+        self->count = 0;
+        self->phase = SLOPE_PHASE_ONE;
+        *seg++ = breakpoint_action( self );
+        size--;
+    }
+    return out;
+}
+
+static float* fixed_static_v( Slope_t* self, float* out, int size )
+{
+    float* out2 = out;
+    self->here = (float)self->phase * PHASE_TO_F;
+    for( int i=0; i<size; i++ ){
+        *out2++ = self->here;
+    }
+    return shaper_v( self, out, size );
+}
+
+static float* fixed_motion_v( Slope_t* self, float* out, int size )
+{
+    float* out2 = out;
+    uint32_t phase = self->phase;
+    uint32_t err   = self->err;
+    for( int i=0; i<size; i++ ){
+        phase += self->inc;
+        err   += self->rem;
+        if( err >= self->length ){
+            phase++;
+            err -= self->length;
+        }
+        *out2++ = (float)phase * PHASE_TO_F;
     }
+    self->phase = phase;
+    self->err   = err;
+    self->count -= size;
+    self->here = out[size-1];
+    return shaper_v( self, out, size );
 }
 
 
@@ -238,15 +480,12 @@ static float* shaper_v( Slope_t* self, float* out, int size )
         case SHAPE_Sine:    out = shapes_v_sin( out, size ); break;
         case SHAPE_Log:     out = shapes_v_log( out, size ); break;
         case SHAPE_Expo:    out = shapes_v_exp( out, size ); break;
-        case SHAPE_Linear: break;
-        default: { // if no vector, use single-sample
-            float* out2 = out;
-            for( int i=0; i<size; i++ ){
-                *out2 = shaper( self, *out2 );
-                out2++;
-            }
-            // shaper() cleans up self->shaped etc
-            return out; }
+        case SHAPE_Now:     out = shapes_v_step_now( out, size ); break;
+        case SHAPE_Wait:    out = shapes_v_step_wait( out, size ); break;
+        case SHAPE_Over:    out = shapes_v_ease_out_back( out, size ); break;
+        case SHAPE_Under:   out = shapes_v_ease_in_back( out, size ); break;
+        case SHAPE_Rebound: out = shapes_v_ease_out_rebound( out, size ); break;
+        case SHAPE_Linear: default: break; // Linear falls through
     }
     // map to output range
     b_add(
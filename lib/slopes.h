@@ -1,11 +1,7 @@
 #pragma once
 
 #include <stdint.h>
-
-// need an Init() fn. send SR as an argument
-#define SAMPLE_RATE 48000
-#define iSAMPLE_RATE (1.0/(float)SAMPLE_RATE)
-#define SAMPLES_PER_MS ((float)SAMPLE_RATE/1000.0)
+#include <stdbool.h>
 
 typedef enum{ SHAPE_Linear
             , SHAPE_Sine
@@ -18,8 +14,26 @@ typedef enum{ SHAPE_Linear
             , SHAPE_Rebound
 } Shape_t;
 
+// Float tracks progress with here/delta/countdown
+// Fixed uses a Q31 phase accumulator & integer sample count for exact timing
+typedef enum{ SLOPE_Float
+            , SLOPE_Fixed
+} SlopeMode_t;
+
+#define SLOPE_PHASE_ONE ((uint32_t)1 << 31) // fixed-point 1.0
+
 typedef void (*Callback_t)(int channel);
 
+// pre-resolved segments, popped at a breakpoint instead of calling action
+#define SLOPE_QUEUE_LEN  4 // power of 2
+#define SLOPE_QUEUE_MASK (SLOPE_QUEUE_LEN-1)
+
+typedef struct{
+    float   dest;
+    float   ms;
+    Shape_t shape;
+} SlopeSeg_t;
+
 typedef struct{
     int         index;
     // destination
@@ -34,21 +48,56 @@ typedef struct{
     float       delta;     // increment per sample
     float       countdown; // samples until breakpoint
 
+    // fixed-point state (SLOPE_Fixed)
+    SlopeMode_t mode;
+    uint32_t    phase;  // Q31 position in segment (0,SLOPE_PHASE_ONE)
+    uint32_t    inc;    // phase increment per sample
+    uint32_t    rem;    // remainder of inc. spread across the segment
+    uint32_t    err;    // accumulated remainder
+    uint32_t    length; // segment length in samples (divisor of rem)
+    uint32_t    count;  // samples until breakpoint. 0 at destination
+    float       carry;  // fractional samples carried into the next segment
+
+    // segment queue. single producer (main loop), single consumer (audio ISR)
+    SlopeSeg_t          queue[SLOPE_QUEUE_LEN];
+    volatile uint8_t    q_read;  // free-running. advanced by ISR
+    volatile uint8_t    q_write; // free-running. advanced by producer
+    Callback_t          refill;  // called from ISR after popping the queue
+
     // pre-calcd
     float scale; // dest - last
     float shaped; // current shaped output voltage
 } Slope_t;
 
-#define SLOPE_CHANNELS 4
+#define SLOPE_OUTPUTS 4 // one per DAC channel
+
+// virtual slopes follow the outputs (index >= SLOPE_OUTPUTS)
+// they are rendered every block, but only reach the DAC via the IO mix stage
+#ifndef SLOPE_VIRTUALS
+#define SLOPE_VIRTUALS 4
+#endif
+#if SLOPE_VIRTUALS < 1
+#error "SLOPE_VIRTUALS must be at least 1"
+#endif
+
+#define SLOPE_CHANNELS (SLOPE_OUTPUTS + SLOPE_VIRTUALS)
 
 // refactor for dynamic SLOPE_CHANNELS
-// refactor for dynamic SAMPLE_RATE
 // refactor to S_init returning pointers, but internally tracking indexes?
 
-void S_init( int channels );
+void S_init( int channels, int sample_rate );
 
 Shape_t S_str_to_shape( const char* s );
 
+void S_set_mode( int index, SlopeMode_t mode );
+
+// segment queue
+bool S_queue_push( int index, float destination, float ms, Shape_t shape );
+void S_queue_clear( int index );
+int S_queue_space( int index );
+float S_queue_lead( int index ); // ms of motion already resolved
+void S_set_refill( int index, Callback_t cb );
+
 float S_get_state( int index );
 void S_toward( int        index
              , float      destination
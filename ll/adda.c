@@ -25,21 +25,42 @@ typedef struct {
 static CAL_t cal;
 static void CAL_ReadFlash( void );
 
+static int sample_rate = ADDA_SAMPLE_RATE;
+static uint16_t block_size = ADDA_BLOCK_SIZE;
 
-uint16_t ADDA_Init( int adc_timer_ix )
+
+uint16_t ADDA_Init( int adc_timer_ix, int rate, int bsize )
 {
-    ADC_Init( ADDA_BLOCK_SIZE
+    switch( rate ){ // I2S can only derive these from the PLL
+        case 8000: case 16000: case 24000: case 48000: case 96000:
+            sample_rate = rate; break;
+        default:
+            printf("ADDA: unsupported sample rate %i\n", rate);
+            sample_rate = ADDA_SAMPLE_RATE; break;
+    }
+    if( bsize < 1 || bsize > ADDA_BLOCK_SIZE_MAX ){
+        printf("ADDA: unsupported block size %i\n", bsize);
+        bsize = ADDA_BLOCK_SIZE;
+    }
+    block_size = bsize;
+
+    ADC_Init( block_size
             , ADDA_ADC_CHAN_COUNT
             , adc_timer_ix
+            , sample_rate
             );
-    DAC_Init( ADDA_BLOCK_SIZE
+    DAC_Init( block_size
             , ADDA_DAC_CHAN_COUNT
+            , sample_rate
             );
     CAL_LL_Init();
     CAL_ReadFlash();
-    return ADDA_BLOCK_SIZE;
+    return block_size;
 }
 
+int ADDA_GetSampleRate( void ){ return sample_rate; }
+int ADDA_GetBlockSize( void ){ return block_size; }
+
 void ADDA_Start( void )
 {
     DAC_Start();
@@ -47,14 +68,17 @@ void ADDA_Start( void )
 
 void ADDA_BlockProcess( uint32_t* dac_pickle_ptr )
 {
-    IO_block_t b = { .size = ADDA_BLOCK_SIZE };
+    static IO_block_t b; // too big for the ISR stack at ADDA_BLOCK_SIZE_MAX
+    b.size = block_size;
     ADC_UnpickleBlock( b.in[0]
-                     , ADDA_BLOCK_SIZE
+                     , block_size
+                     , ADDA_BLOCK_SIZE_MAX
                      );
     IO_BlockProcess( &b );
     DAC_PickleBlock( dac_pickle_ptr
                    , b.out[0]
-                   , ADDA_BLOCK_SIZE
+                   , block_size
+                   , ADDA_BLOCK_SIZE_MAX
                    );
 }
 
@@ -2,17 +2,27 @@
 
 #include <stm32f7xx.h>
 
+// defaults. the running config is chosen in ADDA_Init()
+#define ADDA_SAMPLE_RATE    48000
 #define ADDA_BLOCK_SIZE     32
+#define ADDA_BLOCK_SIZE_MAX 128 // IO_block_t storage
+
 #define ADDA_DAC_CHAN_COUNT 4
 #define ADDA_ADC_CHAN_COUNT 2
 
+// only the first 'size' samples of each channel are valid
 typedef struct{
-    float    in[ ADDA_ADC_CHAN_COUNT][ADDA_BLOCK_SIZE];
-    float    out[ADDA_DAC_CHAN_COUNT][ADDA_BLOCK_SIZE];
+    float    in[ ADDA_ADC_CHAN_COUNT][ADDA_BLOCK_SIZE_MAX];
+    float    out[ADDA_DAC_CHAN_COUNT][ADDA_BLOCK_SIZE_MAX];
     uint16_t size;
 } IO_block_t;
 
-uint16_t ADDA_Init( int adc_timer_ix );
+// sample_rate: 8000, 16000, 24000, 48000 or 96000
+// block_size:  1 to ADDA_BLOCK_SIZE_MAX
+// unsupported values fall back to the defaults. returns the block size in use
+uint16_t ADDA_Init( int adc_timer_ix, int sample_rate, int block_size );
+int ADDA_GetSampleRate( void );
+int ADDA_GetBlockSize( void );
 void ADDA_Start( void );
 void ADDA_BlockProcess( uint32_t* dac_pickle_ptr );
 
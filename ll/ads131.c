@@ -2,6 +2,7 @@
 
 #include <stm32f7xx_hal.h>
 #include <stdio.h>
+#include <math.h> // ceilf()
 
 #include "timers.h"
 #include "debug_pin.h"
@@ -11,6 +12,8 @@
 //#define ADC_BUF_SIZE   (ADC_FRAMES)
 
 #define NSS_DELAY 10000
+
+#define ADC_CONVERSION_TIME 0.000666 // seconds. resync + settle + OSR averaging
 #define DELAY_usec(u) \
     do{ for( volatile int i=0; i<u; i++ ){;;} \
     } while(0);
@@ -30,6 +33,10 @@ float adc_calibrated_shift[ADC_COUNTT];
 
 int timer_index_ads;
 
+// short blocks only request a new conversion every 'adc_block_div' blocks
+static int adc_block_div = 1;
+static int adc_block_count = 0;
+
 void ADS_Init_Sequence(void);
 void ADS_Reset_Device(void);
 uint8_t ADS_IsReady( void );
@@ -45,11 +52,15 @@ static void ADC_UnpickleBlock_Cont( int unused );
 
 #define ADC_U16_TO_V        ((float)(15.0 / 65535.0))
 
-void ADC_Init( uint16_t bsize, uint8_t chan_count, int timer_ix )
+void ADC_Init( uint16_t bsize, uint8_t chan_count, int timer_ix, int sample_rate )
 {
     adc_count  = chan_count;
     adc_samp_count = bsize * chan_count;
 
+    adc_block_div = (int)ceilf( ADC_CONVERSION_TIME * (float)sample_rate / (float)bsize );
+    if( adc_block_div < 1 ){ adc_block_div = 1; }
+    adc_block_count = 0;
+
     // Set the SPI parameters
     adc_spi.Instance               = SPIa;
     adc_spi.Init.Mode              = SPI_MODE_MASTER;
@@ -115,7 +126,7 @@ void ADC_Init( uint16_t bsize, uint8_t chan_count, int timer_ix )
     // it continues sampling while it awaits the SPI transmission.
     // so we increase the delay time to the max, to be able to use the highest OSR ratio
     timer_index_ads = timer_ix;
-    Timer_Set_Params( timer_index_ads, 0.00063 ); // 630uS (block is 666uS)
+    Timer_Set_Params( timer_index_ads, 0.00063 ); // 630uS (conversion is 666uS)
     Timer_Priority( timer_index_ads, ADC_IRQPriority );
 
     ADS_Init_Sequence();
@@ -209,11 +220,12 @@ uint16_t ADS_Cmd( uint16_t command )
 static float last[2] = {0.0,0.0};
 void ADC_UnpickleBlock( float*   unpickled
                       , uint16_t bsize
+                      , uint16_t stride
                       )
 {
-    float* unpick = unpickled;
     // Return current buf
     for( uint8_t j=0; j<adc_count; j++ ){
+        float* unpick = &unpickled[j*stride];
         // cast to signed -> cast to float -> scale -> shift
         float once = ((float)((int16_t*)aRxBuffer)[j+1]) // +1 past status byte
                         * adc_calibrated_scalar[j]
@@ -224,6 +236,10 @@ void ADC_UnpickleBlock( float*   unpickled
         last[j] = once;
     }
 
+    // wait for the current conversion if blocks are shorter than its settling time
+    if( ++adc_block_count < adc_block_div ){ return; }
+    adc_block_count = 0;
+
     // Request next buffer
     if (HAL_SPI_GetState(&adc_spi) == HAL_SPI_STATE_READY){
         HAL_GPIO_WritePin( SPIa_NSS_GPIO_PORT, SPIa_NSS_PIN, 0 );
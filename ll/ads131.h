@@ -98,12 +98,13 @@
 
 #define ADS_DATAWORDSIZE 0x2 // 16bit, pin M1 floats
 
-void ADC_Init( uint16_t bsize, uint8_t chan_count, int timer_ix );
+void ADC_Init( uint16_t bsize, uint8_t chan_count, int timer_ix, int sample_rate );
 
 //int32_t
 uint16_t ADC_GetU16( uint8_t channel );
 void ADC_UnpickleBlock( float*   unpickled
                       , uint16_t bsize
+                      , uint16_t stride
                       );
 float ADC_GetValue( uint8_t channel );
 
@@ -21,7 +21,7 @@ uint32_t* samples = NULL;
 float dac_calibrated_offset[DAC_CHANNELSS];
 float dac_calibrated_scalar[DAC_CHANNELSS];
 
-void DAC_Init( uint16_t bsize, uint8_t chan_count )
+void DAC_Init( uint16_t bsize, uint8_t chan_count, int sample_rate )
 {
     // Create the sample buffer for DMA transfer
     samp_count = DAC_BUFFER_COUNT * bsize * chan_count;
@@ -40,7 +40,7 @@ void DAC_Init( uint16_t bsize, uint8_t chan_count )
     dac_i2s.Init.Standard     = I2S_STANDARD_PCM_SHORT;
     dac_i2s.Init.DataFormat   = I2S_DATAFORMAT_24B;
     dac_i2s.Init.MCLKOutput   = I2S_MCLKOUTPUT_ENABLE;
-    dac_i2s.Init.AudioFreq    = I2S_AUDIOFREQ_96K;
+    dac_i2s.Init.AudioFreq    = 2 * sample_rate; // 4 channels in a stereo frame
     dac_i2s.Init.CPOL         = I2S_CPOL_LOW;
     dac_i2s.Init.ClockSource  = I2S_CLOCK_SYSCLK;
 
@@ -107,21 +107,23 @@ int32_t lim_i32_u16( int32_t v )
 /* Does all the work converting a generic representation into serial packets
  * Convert floats (representing volts) to u16 representation
  * Interleave a block of each channel into a stream
+ * Channels are 'stride' floats apart in unpickled_data
  * */
 void DAC_PickleBlock( uint32_t* dac_pickle_ptr
                     , float*    unpickled_data
                     , uint16_t  bsize
+                    , uint16_t  stride
                     )
 {
     for( uint8_t j=0; j<4; j++ ){
-        add_vf_f( &(unpickled_data[j*bsize])
+        add_vf_f( &(unpickled_data[j*stride])
                 , dac_calibrated_offset[j]
-                , &(unpickled_data[j*bsize])
+                , &(unpickled_data[j*stride])
                 , bsize
                 );
     }
     for( uint8_t j=0; j<4; j++ ){
-        mul_vf_f( &(unpickled_data[j*bsize])
+        mul_vf_f( &(unpickled_data[j*stride])
                 , dac_calibrated_scalar[j] // scale volts up to u16
                 , bsize
                 );
@@ -134,7 +136,7 @@ void DAC_PickleBlock( uint32_t* dac_pickle_ptr
         for( uint8_t j=0; j<4; j++ ){
             *usixp++ = (uint16_t)lim_i32_u16( DAC_ZERO_VOLTS
                                    //- (int32_t)(*u[j]++)
-                                   - (int32_t)(unpickled_data[i+j*bsize])
+                                   - (int32_t)(unpickled_data[i+j*stride])
                                  );
         }
     }
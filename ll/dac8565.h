@@ -50,7 +50,7 @@
 #define DAC8565_SET_ALL        ((uint8_t)0b00110100)
 #define DAC8565_REFRESH_ALL    ((uint8_t)0b00110000)
 
-void DAC_Init( uint16_t bsize, uint8_t chan_count );
+void DAC_Init( uint16_t bsize, uint8_t chan_count, int sample_rate );
 void DAC_Start(void);
 
 void DAC_CalibrateScalar( uint8_t channel, float scale );
@@ -58,6 +58,7 @@ void DAC_CalibrateOffset( uint8_t channel, float volts );
 void DAC_PickleBlock( uint32_t* dac_pickle_ptr
                     , float*    unpickled_data
                     , uint16_t  bsize
+                    , uint16_t  stride
                     );
 
 void I2Sx_DMA_TX_IRQHandler(void);
@@ -5,10 +5,17 @@
 
 static RNG_HandleTypeDef r;
 
-#define BUFLEN 16
+// ring of hardware values. filled by the RNG IRQ, read from the main loop & audio ISR
+#define BUFLEN 64 // power of 2
 static float buf[BUFLEN];
-static int8_t head = 0;
-static int8_t count = 0;
+static volatile uint32_t wr = 0; // free-running. advanced by RNG IRQ
+static volatile uint32_t rd = 0; // free-running. advanced by consumers
+
+// xorshift fallback so an underrun returns noise rather than stale values
+static uint32_t fallback = 0x9E3779B9;
+static uint32_t underruns = 0;
+
+#define U32_TO_FLOAT(u) ((float)((u) >> 8) * (1.0/16777216.0)) // [0,1)
 
 void Random_Init(void)
 {
@@ -54,24 +61,40 @@ void HAL_RNG_ErrorCallback( RNG_HandleTypeDef* hr )
 
 void HAL_RNG_ReadyDataCallback( RNG_HandleTypeDef* hr, uint32_t rand32 )
 {
-    if( count < BUFLEN ){ // make sure we have room to store the val
-        int8_t ix = (head + count++) % BUFLEN;
-        buf[ix] = (float)rand32 / (1.0 + (float)(uint32_t)0xFFFFFFFF);
+    if( wr - rd < BUFLEN ){ // make sure we have room to store the val
+        buf[wr & (BUFLEN-1)] = U32_TO_FLOAT(rand32);
+        wr++;
+        if( rand32 ){ fallback = rand32; } // reseed. xorshift state can't be 0
         Random_Update();
     }
 }
 
 float Random_Float(void)
 {
-    if( count <= 0 ){ printf("rng: underrun\n"); }
-    float retval = buf[head++];
-    head %= BUFLEN;
-    if( --count < (BUFLEN/4) ){ // update if 3/4 empty
+    float retval;
+    BLOCK_IRQS(
+        if( rd != wr ){
+            retval = buf[rd & (BUFLEN-1)];
+            rd++;
+        } else {
+            underruns++;
+            fallback ^= fallback << 13;
+            fallback ^= fallback >> 17;
+            fallback ^= fallback << 5;
+            retval = U32_TO_FLOAT(fallback);
+        }
+    );
+    if( wr - rd < (BUFLEN/4) ){ // update if 3/4 empty
         Random_Update();
     }
     return retval;
 }
 
+uint32_t Random_Underruns(void)
+{
+    return underruns;
+}
+
 int Random_Int(int lower, int upper)
 {
     return (int)(Random_Float() * (float)(1 + upper - lower)) + lower;
@@ -79,8 +102,8 @@ int Random_Int(int lower, int upper)
 
 void Random_Update(void)
 {
-    if( count != BUFLEN ){
-        if( HAL_RNG_GenerateRandomNumber_IT(&r) ){
+    if( wr - rd < BUFLEN ){
+        if( HAL_RNG_GenerateRandomNumber_IT(&r) == HAL_ERROR ){ // BUSY if already filling
             printf("rng failed to fill\n");
         }
     }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdint.h>
+
 #define RNG_IRQPriority 4
 #define RNG_IRQSubPriority 1
 
@@ -11,6 +13,7 @@ void Random_DeInit(void);
 // Get a single random value with these 2 fns
 float Random_Float(void);
 int Random_Int(int lower, int upper);
+uint32_t Random_Underruns(void); // count of values served by the software fallback
 
 // Place Update in the main loop to keep random buffer full
 void Random_Update(void);
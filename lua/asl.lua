@@ -6,7 +6,7 @@ local Dynmt = {
 }
 
 function Asl.new(id)
-    local c = {id = id or 1}
+    local c = {id = id or 1, _defaults = {}, cached = false}
     c.dyn = setmetatable({_names={}, id=c.id}, Dynmt) -- needs link to `id`
     setmetatable(c, Asl)
     return c
@@ -21,7 +21,11 @@ function Asl.link(self, tab)
             return v(self, tab[2]) -- call compiler fn with self & return new table
             -- early return bc fn must be in the first position, and consumes following arg
         elseif typ == 'table' then
-            t2[k] = Asl.link(self, v) -- link nested tables (won't copy unchanged tables)
+            if sequins and sequins.is_sequins(v) then
+                t2[k] = Asl.sequins(self, v) -- stepped natively in C
+            else
+                t2[k] = Asl.link(self, v) -- link nested tables (won't copy unchanged tables)
+            end
         else
             t2[k] = v -- copy value into new table
         end
@@ -29,10 +33,122 @@ function Asl.link(self, tab)
     return t2
 end
 
+-- flatten a sequins into {'SEQN', step, ix, set_ix, values...}
+-- values & step can be numbers, shapes, dynamics or nested sequins
+-- casl holds its own copy, so the sequins object isn't advanced by the ASL
+-- flow modifiers (every, count, times, etc) only run in lua, so are rejected
+function Asl.sequins(self, s)
+    if s.action.action then
+        error('asl: sequins flow modifiers (every, count, times, etc) are not supported in ASL', 0)
+    end
+    local function elem(v)
+        if type(v) ~= 'table' then return v end
+        return Asl.link(self, {v})[1] -- reuse link to handle sequins & dyn
+    end
+    local t = {'SEQN', elem(s.n), s.ix, rawget(s, 'set_ix') or 0}
+    for i=1, s.length do t[i+4] = elem(s.data[i]) end
+    return t
+end
+
+-- binary form of a linked description, parsed by C in a single pass
+-- see lib/casl.h for the format
+local pack = string.pack
+local stateful -- set when the description holds values that a re-parse resets
+local Stateful = {M=true, S=true, H=true} -- mutable, sequins, sample & hold
+
+local function ser_elem(b, e)
+    local typ = type(e)
+    if typ == 'number' then b[#b+1] = pack('<c1f', 'f', e)
+    elseif typ == 'boolean' then b[#b+1] = pack('<c1f', 'f', e and 1 or 0)
+    elseif typ == 'string' then b[#b+1] = pack('<c1c2', 's', e:sub(1,2)) -- shape
+    elseif typ == 'table' then
+        local k = e[1]:sub(1,1)
+        local n = rawlen(e) -- math tables overload #
+        if Stateful[k] then stateful = true end
+        if k == 'D' or k == 'N' then b[#b+1] = pack('<c1I2', k, e[2]) -- dynamic refs
+        elseif k == 'S' then -- {'SEQN', step, ix, set_ix, values...}
+            b[#b+1] = pack('<c1I2i2i2', 'S', n-4, e[3], e[4])
+            ser_elem(b, e[2])
+            for i=5, n do ser_elem(b, e[i]) end
+        elseif k == 'R' and n < 3 then b[#b+1] = 'r' -- rand()
+        else -- operator followed by its operands
+            b[#b+1] = k
+            for i=2, n do ser_elem(b, e[i]) end
+        end
+    else b[#b+1] = '?' end -- C reports the unhandled type
+end
+
+local function ser_stage(b, t)
+    local s = t[1]
+    if type(s) == 'string' then -- TO, RECUR, IF, etc
+        local k = s:sub(1,1)
+        b[#b+1] = k
+        if k == 'T' then ser_elem(b, t[2]); ser_elem(b, t[3]); ser_elem(b, t[4])
+        elseif k == 'I' then ser_elem(b, t[2]) end
+    elseif type(s) == 'table' then -- NEST
+        b[#b+1] = '['
+        for i=1, rawlen(t) do ser_stage(b, t[i]) end
+        b[#b+1] = ']'
+    else b[#b+1] = '?' end
+end
+
+-- returns the binary string, and whether it is stateful
+function Asl.serialize(t)
+    local b = {}
+    stateful = false
+    ser_stage(b, t)
+    return table.concat(b), stateful
+end
+
+-- names & defaults of the dynamics in a description, so edits to its dyn{} tables miss the cache
+local function dyn_sig(t, b)
+    if rawget(t, 1) == Asl.dyn_compiler then
+        local elem = t[2]
+        if elem[1] == 'NMUT' then elem = elem[2] end -- unwrap named mutables
+        local k,v = next(elem)
+        b[#b+1] = tostring(k)
+        b[#b+1] = tostring(v)
+    else
+        for _,v in pairs(t) do
+            if type(v) == 'table' then dyn_sig(v, b) end
+        end
+    end
+    return b
+end
+
+-- re-describing with the same table (and the same dynamic names & defaults) skips the link & parse
+-- stateful descriptions aren't cached, as the re-parse is what resets them
+Asl.hits, Asl.misses = 0, 0
+
 function Asl:describe(d)
+    local c = self.cached
+    if c and rawequal(c.desc, d) and c.sig == table.concat(dyn_sig(d, {}), '\0') then
+        Asl.hits = Asl.hits + 1
+        for k,v in pairs(self._defaults) do self.dyn[k] = v end -- as link would
+        return
+    end
+    Asl.misses = Asl.misses + 1
     casl_cleardynamics(self.id)
     self.dyn._names = {} -- clear local dynamic refs
-    casl_describe(self.id, Asl.link(self, d))
+    self._defaults = {}
+    local bin, stateful = Asl.serialize(Asl.link(self, d))
+    casl_describe_bin(self.id, bin)
+    self.cached = not stateful and {desc = d, sig = table.concat(dyn_sig(d, {}), '\0')}
+end
+
+-- describe cache counters, summed over all ASLs
+function Asl.cache_stats() return Asl.hits, Asl.misses end
+
+-- memory shared by all ASLs. when called as a method, 'used' is this ASL's share
+-- and 'saved' is the count of nodes the optimizer removed from its description
+function Asl.arena(self)
+    local t = {}
+    for i,k in ipairs{'to', 'seq', 'dyn', 'code'} do
+        local used, high, size = casl_arena(i, self and self.id)
+        t[k] = {used = used, high = high, size = size}
+    end
+    if self then t.saved = casl_optimized(self.id) end
+    return t
 end
 
 function Asl.set_held(self, b)
@@ -66,6 +182,7 @@ function Asl.dyn_compiler(self, d)
     end
     local ref = self.dyn._names[k]
     self.dyn[k] = v -- set the default
+    self._defaults[k] = v -- restored when a cached description is re-applied
     return {typ, ref}
 end
 
@@ -161,6 +278,19 @@ function mutable(n)
 end
 
 
+-- random values, drawn from the hardware RNG at each breakpoint
+-- rand() is uniform in [0,1). rand(max) & rand(min, max) pick from a range
+function rand(a, b)
+    if a == nil then return Asl.math{'RAND'} end
+    if b == nil then a, b = 0, a end
+    return Asl.math{'RAND', a, b}
+end
+
+-- sample & hold: takes a new value of 'src' every 'n' breakpoints, otherwise repeats it
+-- usage: to(sah(rand(-5, 5), 4), 0.1) -- new random level every 4th stage
+function sah(src, n) return Asl.math{'HOLD', src, n or 1} end
+
+
 -- composite constructs
 
 function Asl._while(pred, t) return loop( Asl._if(pred, t)) end
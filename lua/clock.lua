@@ -100,10 +100,14 @@ function clock_start_handler() if clock.transport.start then clock.transport.sta
 function clock_stop_handler()  if clock.transport.stop then clock.transport.stop() end end
 
 clock.__newindex = function(self, ix, val)
-    if ix == 'tempo' then clock_internal_set_tempo(val) end
+    if ix == 'tempo' then clock_internal_set_tempo(val)
+    elseif ix == 'smoothing' then clock_crow_smoothing(val) -- input clock tempo tracking. 0..1
+    end
 end
 clock.__index = function(self, ix)
-    if ix == 'tempo' then return clock_get_tempo() end
+    if ix == 'tempo' then return clock_get_tempo()
+    elseif ix == 'locked' then return (clock_crow_status()) -- tracking the input clock
+    end
 end
 
 setmetatable(clock, clock)
@@ -23,11 +23,20 @@ function C.reset()
     end
     for n=1,4 do
         output[n].slew = 0
+        output[n].fixedpoint = false
         output[n].volts = 0
         output[n].scale('none')
         output[n].done = function() end
         output[n]:clock('none')
     end
+    for n=1,#virtual do
+        virtual[n].slew = 0
+        virtual[n].fixedpoint = false
+        virtual[n].volts = 0
+        virtual[n].done = function() end
+        virtual[n]:clock('none')
+        for o=1,#output do virtual[n]:route(o, 0) end
+    end
     ii.reset_events(ii.self)
     ii_follow_reset() -- resets forwarding to output libs
     metro.free_all()
@@ -66,10 +75,17 @@ for chan = 1, #output do
     output[chan] = Output.new( chan )
 end
 
+--- Virtual slopes: ASL voices with no output, routed or read from Lua
+virtual = {}
+for n = 1, virtual_count() do
+    virtual[n] = Output.new( #output + n )
+end
+
 
 --- asl
 asl_done_handler = function(id)
-    output[id].done()
+    if id > #output then virtual[id - #output].done()
+    else output[id].done() end
 end
 
 function LL_get_state( id )
@@ -146,16 +146,31 @@ end
 setmetatable(Input, Input) -- capture the metamethods
 
 -- callback
-function stream_handler( chan, val ) Input.inputs[chan].stream( val ) end
-function change_handler( chan, val ) Input.inputs[chan].change( val ~= 0 ) end
+-- stream, change, volume & freq receive a burst of (chan, val) pairs in one call
+-- batch_done counts finished pairs, so C can resume after an error
+batch_done = 0
+local function each(fn, chan, val, ...)
+    if chan then
+        fn(chan, val)
+        batch_done = batch_done + 1
+        return each(fn, ...)
+    end
+end
+local function stream(chan, val) Input.inputs[chan].stream( val ) end
+local function change(chan, val) Input.inputs[chan].change( val ~= 0 ) end
+local function volume(chan, val) Input.inputs[chan].volume( val ) end
+local function freq(chan, val) Input.inputs[chan].freq( val ) end
+
+function stream_handler( ... ) batch_done = 0; each(stream, ...) end
+function change_handler( ... ) batch_done = 0; each(change, ...) end
 function window_handler( chan, win, dir ) Input.inputs[chan].window( win, dir ~= 0 ) end
 function scale_handler(chan,i,o,n,v)
     --TODO build this table in C as it'll be faster?
     s={index=i, octave=o, note=n, volts=v}
     Input.inputs[chan].scale(s)
 end
-function volume_handler( chan, val ) Input.inputs[chan].volume( val ) end
+function volume_handler( ... ) batch_done = 0; each(volume, ...) end
 function peak_handler( chan ) Input.inputs[chan].peak() end
-function freq_handler( chan, val ) Input.inputs[chan].freq( val ) end
+function freq_handler( ... ) batch_done = 0; each(freq, ...) end
 
 return Input
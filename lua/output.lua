@@ -11,25 +11,25 @@ function Output.new( chan )
               , asl     = asl.new( chan )
               , done    = function() end -- customizable event called on asl completion
               , clock_div = 1
-              , ckcoro  = false -- clock coroutine
+              , ckpulse = false -- reused so re-clocking hits the describe cache
               }
     return setmetatable( o, Output )
 end
 
 function Output.clock(self, div)
     if type(div) == 'string' then -- 'off' or 'none' will cancel a running output clock
-        if self.ckcoro then clock.cancel(self.ckcoro) end
+        clock_cancel_asl(self.channel)
         return
     end
     self.clock_div = div or self.clock_div
-    self.asl:describe(pulse())
-    if self.ckcoro then clock.cancel(self.ckcoro) end -- replace the existing coro
-    self.ckcoro = clock.run(function()
-            while true do
-                clock.sync(self.clock_div)
-                self.asl:action()
-            end
-        end)
+    self.ckpulse = self.ckpulse or pulse()
+    self.asl:describe(self.ckpulse)
+    clock_schedule_asl(self.channel, self.clock_div) -- retriggered by the C scheduler. replaces any existing
+end
+
+-- virtual slopes only: sum into output[out] at level. level of 0 disconnects
+function Output.route(self, out, level)
+    set_virtual_mix(self.channel, out, level or 1.0)
 end
 
 --- METAMETHODS
@@ -40,11 +40,14 @@ Output.__newindex = function(self, ix, val)
             val = assert(load('return '..val))()
         end
         self.asl:describe(val)
-    elseif ix == 'volts' then
-        self.asl:describe(to(val, self.slew, self.shape))
-        self.asl:action()
+    elseif ix == 'volts' then -- direct to C. avoids building & parsing a to() table
+        if next(self.asl.dyn._names) then self.asl.dyn._names = {} end
+        self.asl.cached = false -- casl_to replaces the description
+        casl_to(self.channel, val, self.slew, self.shape)
     elseif ix == 'scale' then
         set_output_scale(self.channel, self.ji and just12(val) or val)
+    elseif ix == 'fixedpoint' then -- sample-exact slope timing
+        set_output_fixed(self.channel, val)
     end
 end
 
@@ -54,6 +57,7 @@ Output.__index = function(self, ix)
         return function(...) return self.asl:action(...) end
     elseif ix == 'volts' then return LL_get_state(self.channel)
     elseif ix == 'clock' then return Output.clock
+    elseif ix == 'route' then return Output.route
     elseif ix == 'scale' then return
         function(...) -- return lambda as we're closing over self
             local args = {...}
@@ -30,10 +30,13 @@ int main(void)
 
     // Drivers
     int max_timers = Timer_Init();
-    IO_Init( max_timers-2 ); // use second-last timer
+    IO_Init( max_timers-2 // use second-last timer
+           , ADDA_SAMPLE_RATE
+           , ADDA_BLOCK_SIZE
+           );
     IO_Start(); // must start IO before running lua init() script
     events_init();
-    Metro_Init( max_timers-2 ); // reserve 2 timers for USB & ADC
+    Metro_Init( MAX_NUM_METROS ); // scheduled on the sample clock, not timers
     clock_init( 100 ); // TODO how to pass it the timer?
     Caw_Init( max_timers-1 ); // use last timer
     CDC_clear_buffers();
@@ -68,7 +71,7 @@ int main(void)
         }
         Random_Update();
         clock_update();
-        event_next(); // check/execute single event
+        event_drain(); // execute events until empty or out of time
         ii_leader_process();
     }
 }
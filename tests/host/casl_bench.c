@@ -0,0 +1,107 @@
+// cost of resolving nested dyn arithmetic at a breakpoint: the element tree
+// walked by _resolve, against the bytecode compile_all makes of it.
+// one description is parsed twice from its binary form: channel 0 as
+// casl_describe_bin leaves it, channel 1 without the compile step
+
+#include <stdio.h>
+#include <string.h>
+
+#include "lib/casl.c"
+#include "casl_stubs.h"
+
+#define RESOLVES 1000000
+
+// builds the binary form, as Asl.serialize would
+typedef struct{
+    char   b[256];
+    size_t len;
+    int    dyns[16]; // dynamic refs of the channel being described
+} Bin;
+
+static void put( Bin* b, const void* data, size_t len ){ memcpy( &b->b[b->len], data, len ); b->len += len; }
+static void op( Bin* b, char c ){ put( b, &c, 1 ); }
+static void dyn( Bin* b, int n ){ uint16_t ix = b->dyns[n]; op( b, 'D' ); put( b, &ix, 2 ); }
+static void num( Bin* b, float f ){ op( b, 'f' ); put( b, &f, 4 ); }
+
+// to( <expr>, 1.0, 'linear' ) where expr is nested arithmetic over dynamics 0..7
+typedef void (*Expr)( Bin* b );
+static void e_sum( Bin* b ){ op( b, '+' ); dyn( b, 0 ); dyn( b, 1 ); }
+static void e_lfo( Bin* b ){ // (a + b) * c - d / e
+    op( b, '-' ); op( b, '*' ); op( b, '+' ); dyn( b, 0 ); dyn( b, 1 ); dyn( b, 2 );
+                  op( b, '/' ); dyn( b, 3 ); dyn( b, 4 );
+}
+static void e_deep( Bin* b ){ // -(((a + b) * c - d / e) % f + g * (h - 1.5))
+    op( b, '~' ); op( b, '+' ); op( b, '%' ); e_lfo( b ); dyn( b, 5 );
+                                op( b, '*' ); dyn( b, 6 ); op( b, '-' ); dyn( b, 7 ); num( b, 1.5f );
+}
+
+static To* describe( int ch, Expr expr, bool compiled )
+{
+    Casl* self = _selves[ch];
+    Bin b = { .len = 0 };
+    casl_cleardynamics( ch );
+    for( int i=0; i<8; i++ ){
+        b.dyns[i] = casl_defdynamic( ch );
+        casl_setdynamic( ch, b.dyns[i], 0.25f * (float)(i+1) );
+    }
+    op( &b, 'T' ); expr( &b ); num( &b, 1.0f ); op( &b, 's' ); op( &b, 'l' ); op( &b, 'i' );
+    if( compiled ){
+        casl_describe_bin( ch, b.b, b.len );
+    } else { // casl_describe_bin, stopping short of compile_all
+        describe_begin( self );
+        Reader r = { .p = (const uint8_t*)b.b, .end = (const uint8_t*)b.b + b.len, .err = false };
+        bin_stage( self, &r );
+        self->optimized = optimize( self );
+    }
+    return &tos[ seqs[self->seq_root].head ];
+}
+
+static volatile float sink;
+
+static double cycles_per_resolve( int ch, To* t )
+{
+    Casl* self = _selves[ch];
+    float acc = 0.0f;
+    uint32_t start = DWT->CYCCNT;
+    for( int i=0; i<RESOLVES; i++ ){ acc += resolve( self, &t->a ).f; }
+    uint32_t cycles = DWT->CYCCNT - start;
+    sink = acc;
+    return (double)cycles / RESOLVES;
+}
+
+int main( void )
+{
+    struct{ const char* name; Expr expr; } exprs[] =
+        { { "a + b",                        e_sum  }
+        , { "(a + b) * c - d / e",          e_lfo  }
+        , { "-((..) % f + g * (h - 1.5))",  e_deep }
+        };
+    casl_init( 0 );
+    casl_init( 1 );
+    printf( "casl: cycles/resolve @%uMHz. %d resolves\n"
+          , (unsigned)(SystemCoreClock / 1000000), RESOLVES );
+    printf( "%-30s %8s %8s %6s\n", "to(volts)", "tree", "code", "ops" );
+    for( int i=0; i<3; i++ ){
+        To* code_to = describe( 0, exprs[i].expr, true );
+        To* tree_to = describe( 1, exprs[i].expr, false );
+        if( code_to->a.type != ElemT_Program || tree_to->a.type == ElemT_Program ){
+            printf( "casl: %s didn't describe as expected\n", exprs[i].name );
+            return 1;
+        }
+        float code_v = resolve( _selves[0], &code_to->a ).f;
+        float tree_v = resolve( _selves[1], &tree_to->a ).f;
+        if( code_v != tree_v ){
+            printf( "casl: %s resolves to %g as code, %g as a tree\n"
+                  , exprs[i].name, (double)code_v, (double)tree_v );
+            return 1;
+        }
+        int ops = 1;
+        for( const CaslOp* p = &code[code_to->a.obj.dyn]; p->op != OpEnd; p++ ){ ops++; }
+        printf( "%-30s %8.1f %8.1f %6d\n"
+              , exprs[i].name
+              , cycles_per_resolve( 1, tree_to )
+              , cycles_per_resolve( 0, code_to )
+              , ops );
+    }
+    return 0;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+// the rest of the firmware, as far as casl reaches. include after lib/casl.c
+// lua is never called into: descriptions are given in their binary form
+
+lua_Integer luaL_checkinteger( lua_State* L, int ix ){ UNUSED(L); UNUSED(ix); return 0; }
+lua_Number luaL_checknumber( lua_State* L, int ix ){ UNUSED(L); UNUSED(ix); return 0; }
+const char* luaL_checklstring( lua_State* L, int ix, size_t* len ){
+    UNUSED(L); UNUSED(ix); UNUSED(len); return "";
+}
+int lua_gettable( lua_State* L, int ix ){ UNUSED(L); UNUSED(ix); return 0; }
+void lua_settop( lua_State* L, int ix ){ UNUSED(L); UNUSED(ix); }
+void lua_pushnumber( lua_State* L, lua_Number n ){ UNUSED(L); UNUSED(n); }
+size_t lua_rawlen( lua_State* L, int ix ){ UNUSED(L); UNUSED(ix); return 0; }
+int lua_toboolean( lua_State* L, int ix ){ UNUSED(L); UNUSED(ix); return 0; }
+int lua_type( lua_State* L, int ix ){ UNUSED(L); UNUSED(ix); return 0; }
+
+void Caw_printf( char* text, ... ){ UNUSED(text); }
+void L_queue_asl_done( int index ){ UNUSED(index); }
+uint8_t event_post( event_t* e ){ UNUSED(e); return 1; }
+float Random_Float( void ){ return 0.5f; }
+
+Shape_t S_str_to_shape( const char* s ){ UNUSED(s); return SHAPE_Linear; }
+bool S_queue_push( int index, float destination, float ms, Shape_t shape ){
+    UNUSED(index); UNUSED(destination); UNUSED(ms); UNUSED(shape); return false;
+}
+void S_queue_clear( int index ){ UNUSED(index); }
+int S_queue_space( int index ){ UNUSED(index); return SLOPE_QUEUE_LEN; }
+float S_queue_lead( int index ){ UNUSED(index); return 0.0f; }
+void S_set_refill( int index, Callback_t cb ){ UNUSED(index); UNUSED(cb); }
+void S_toward( int index, float destination, float ms, Shape_t shape, Callback_t cb ){
+    UNUSED(index); UNUSED(destination); UNUSED(ms); UNUSED(shape); UNUSED(cb);
+}
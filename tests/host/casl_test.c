@@ -0,0 +1,97 @@
+// dynamics handed to Lua must not outlive their slot
+// casl_to reclaims a channel's dynamics, & the slots are re-used by whichever
+// channel defines a dynamic next. a handle from before the reclaim must then
+// be refused by set & get, & by a description, rather than reach the new owner.
+// also checks that random draws are left for the breakpoint, not prefetched
+
+#include <stdio.h>
+#include <string.h>
+
+#include "lib/casl.c"
+#include "casl_stubs.h"
+
+static int errors = 0;
+#define CHECK(cond, ...) do{ if( !(cond) ){ printf("casl: " __VA_ARGS__); errors++; } }while(0)
+
+// to( dynamic, 1.0, 'linear' ) in the binary form of Asl.serialize
+static void describe_dyn( int ch, int handle )
+{
+    char b[16];
+    size_t len = 0;
+    uint16_t h = handle;
+    float time = 1.0f;
+    b[len++] = 'T';
+    b[len++] = 'D'; memcpy( &b[len], &h, 2 ); len += 2;
+    b[len++] = 'f'; memcpy( &b[len], &time, 4 ); len += 4;
+    b[len++] = 's'; b[len++] = 'l'; b[len++] = 'i';
+    casl_describe_bin( ch, b, len );
+}
+
+// to( rand() + 1.0, 1.0, 'linear' )
+static void describe_rand( int ch )
+{
+    char b[16];
+    size_t len = 0;
+    float one = 1.0f;
+    b[len++] = 'T';
+    b[len++] = '+'; b[len++] = 'r'; b[len++] = 'f'; memcpy( &b[len], &one, 4 ); len += 4;
+    b[len++] = 'f'; memcpy( &b[len], &one, 4 ); len += 4;
+    b[len++] = 's'; b[len++] = 'l'; b[len++] = 'i';
+    casl_describe_bin( ch, b, len );
+}
+
+static To* first_to( int ch ){ return &tos[ seqs[_selves[ch]->seq_root].head ]; }
+
+int main( void )
+{
+    casl_init( 0 );
+    casl_init( 1 );
+    casl_init( 2 );
+
+    // output 1 described with a dynamic, then replaced by casl_to
+    int old = casl_defdynamic( 0 );
+    casl_setdynamic( 0, old, 1.0f );
+    describe_dyn( 0, old );
+    CHECK( first_to(0)->a.type == ElemT_Program, "live dynamic wasn't described\n" );
+    CHECK( casl_getdynamic( 0, old ) == 1.0f, "live dynamic reads %g\n"
+         , (double)casl_getdynamic( 0, old ) );
+    casl_to( 0, 2.0f, 0.1f, SHAPE_Linear );
+
+    // output 2 takes over the slot
+    int taken = casl_defdynamic( 1 );
+    CHECK( taken % DYN_COUNT == old % DYN_COUNT, "slot wasn't re-used. test is void\n" );
+    CHECK( taken != old, "re-used slot has the same handle\n" );
+    casl_setdynamic( 1, taken, 3.0f );
+
+    casl_setdynamic( 0, old, 9.0f ); // the stale Lua proxy
+    CHECK( casl_getdynamic( 1, taken ) == 3.0f, "stale write reached the new owner: %g\n"
+         , (double)casl_getdynamic( 1, taken ) );
+    CHECK( casl_getdynamic( 0, old ) == 0.0f, "stale handle reads %g\n"
+         , (double)casl_getdynamic( 0, old ) );
+
+    casl_setdynamic( 0, taken, 5.0f ); // another channel's live handle
+    CHECK( casl_getdynamic( 1, taken ) == 3.0f, "write through another channel: %g\n"
+         , (double)casl_getdynamic( 1, taken ) );
+
+    // a reclaimed handle can't be described either
+    casl_cleardynamics( 1 );
+    describe_dyn( 1, taken );
+    CHECK( first_to(1)->a.type == ElemT_Float && first_to(1)->a.obj.f == 0.0f
+         , "stale dynamic was described\n" );
+
+    // a compiled random draw must wait for its breakpoint
+    int live = casl_defdynamic( 1 );
+    describe_dyn( 1, live );
+    CHECK( first_to(1)->a.type == ElemT_Program && prefetchable( &first_to(1)->a )
+         , "compiled dynamic isn't prefetched\n" );
+    describe_rand( 2 );
+    CHECK( first_to(2)->a.type == ElemT_Program && !prefetchable( &first_to(2)->a )
+         , "compiled rand() is prefetched\n" );
+
+    if( errors ){
+        printf( "casl: FAILED\n" );
+        return 1;
+    }
+    printf( "casl: ok\n" );
+    return 0;
+}
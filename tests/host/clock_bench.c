@@ -0,0 +1,99 @@
+// cost of clock_block with 1k coroutines asleep at once
+// each coroutine sleeps for a random time, & sleeps again as soon as it wakes,
+// as a lua loop of clock.sleep would. clock_block is timed per audio block,
+// along with the scan over every slot that the heap replaced, for comparison
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lib/clock.c"
+
+#define RATE   48000
+#define BLOCK  32
+#define COROS  1000
+#define TICKS  150000 // blocks. 100s of audio
+
+static uint64_t sample_time = 0;
+uint64_t IO_GetSampleTime( void ){ return sample_time; }
+double IO_GetSampleTimePrecise( void ){ return (double)sample_time; }
+float IO_GetSampleRate( void ){ return RATE; }
+void casl_action( int index, int action ){ UNUSED(index); UNUSED(action); }
+uint8_t event_post( event_t* e ){ UNUSED(e); return 1; }
+void L_queue_clock_start( void ){}
+void L_queue_clock_stop( void ){}
+
+static int woken[ COROS ];
+static int woken_count;
+void L_queue_clock_wakeup( int coro_id, uint32_t wakeup )
+{
+    UNUSED(wakeup);
+    woken[woken_count++] = coro_id;
+}
+
+static uint32_t rng = 1;
+static float sleep_time( void ) // 10ms to 2s
+{
+    rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+    return 0.01f + 1.99f * (float)(rng & 0xFFFF) / 65536.0f;
+}
+
+static volatile int sink;
+
+// the wakeup check before the heap: every slot, every tick
+static int scan( uint64_t now )
+{
+    int due = 0;
+    for( int i=0; i<clock_count; i++ ){
+        if( clock_pool[i].coro_id != -1 && clock_pool[i].wakeup <= now ){ due++; }
+    }
+    return due;
+}
+
+int main( void )
+{
+    clock_init( COROS + 24 );
+    for( int i=0; i<COROS; i++ ){
+        clock_schedule_resume_sleep( i+1, sleep_time() );
+    }
+
+    uint64_t block_cycles = 0, scan_cycles = 0, idle_cycles = 0;
+    uint32_t worst = 0;
+    int wakeups = 0, idle_ticks = 0;
+    for( int t=0; t<TICKS; t++ ){
+        sample_time += BLOCK;
+        woken_count = 0;
+        uint32_t start = DWT->CYCCNT;
+        clock_block();
+        uint32_t cycles = DWT->CYCCNT - start;
+        block_cycles += cycles;
+        if( cycles > worst ){ worst = cycles; }
+        if( !woken_count ){
+            idle_cycles += cycles;
+            idle_ticks++;
+        }
+
+        start = DWT->CYCCNT;
+        sink = scan( sample_time );
+        scan_cycles += DWT->CYCCNT - start;
+
+        // event loop: every woken coroutine goes straight back to sleep
+        wakeups += woken_count;
+        for( int i=0; i<woken_count; i++ ){
+            clock_schedule_resume_sleep( woken[i], sleep_time() );
+        }
+    }
+
+    if( heap_len != COROS ){
+        printf( "clock: %d of %d coroutines still scheduled\n", heap_len, COROS );
+        return 1;
+    }
+    printf( "clock: %d coroutines asleep, %d blocks of %d, %d wakeups\n"
+          , COROS, TICKS, BLOCK, wakeups );
+    printf( "clock: clock_block %.1f cycles/block (%.1f idle), %u worst. scanning every slot %.1f cycles/block\n"
+          , (double)block_cycles / TICKS
+          , (double)idle_cycles / (idle_ticks ? idle_ticks : 1)
+          , worst
+          , (double)scan_cycles / TICKS
+          );
+    return 0;
+}
@@ -0,0 +1,196 @@
+// record/replay test for the clock: crow input tempo tracking & sync wakeups
+// a jittered clock input is recorded once as edge sample times, then replayed
+// block by block through clock.c, as IO_BlockProcess & the event loop drive it.
+// everything the clock reports is logged. two replays of the same recording
+// must log identical output, & a changed recording must not. also checks that
+// the predicted edges land nearer the ideal (unjittered) ones than simply
+// repeating the last measured interval would
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "lib/clock.c"
+
+#define RATE    48000
+#define BLOCK   32
+#define PPQN    4
+#define EDGES   600
+#define JITTER  48 // samples, ie. +/-1ms
+
+// hardware & lua side of the clock
+static uint64_t sample_time = 0;
+uint64_t IO_GetSampleTime( void ){ return sample_time; }
+double IO_GetSampleTimePrecise( void ){ return (double)sample_time; }
+float IO_GetSampleRate( void ){ return RATE; }
+void casl_action( int index, int action ){ UNUSED(index); UNUSED(action); }
+uint8_t event_post( event_t* e ){ UNUSED(e); return 1; }
+void L_queue_clock_start( void ){}
+void L_queue_clock_stop( void ){}
+
+#define CORO_MAX 8
+static int woken[ CORO_MAX ];
+static int woken_count;
+void L_queue_clock_wakeup( int coro_id, uint32_t wakeup )
+{
+    UNUSED(wakeup);
+    if( woken_count < CORO_MAX ){ woken[woken_count++] = coro_id; }
+}
+
+// the recording. edges at 120bpm, then 150bpm, a dropout & a stray edge
+static uint64_t edges[ EDGES ];
+
+static uint32_t rng = 1;
+static int noise( void )
+{
+    rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+    return (int)(rng % (2*JITTER + 1)) - JITTER;
+}
+
+static double ideal[ EDGES ]; // unjittered edge times in seconds. 0 for the stray
+static void record( void )
+{
+    double t = 1.0;
+    for( int i=0; i<EDGES; i++ ){
+        double period = (i < 250) ? 0.5/PPQN : 0.4/PPQN;
+        if( i == 400 ){ t += 5.0; } // input unplugged, beyond CROW_TIMEOUT
+        t += period;
+        ideal[i] = t;
+        edges[i] = (uint64_t)(t * RATE) + noise();
+    }
+    edges[300] = (edges[299] + edges[301]) / 2; // stray edge between two beats
+    ideal[300] = 0.0;
+}
+
+// everything observable after each block with activity
+typedef struct{
+    uint64_t time;
+    float    beats;
+    float    tempo;
+    double   error;
+    int      locked;
+    int      coro; // woken coroutine, or 0
+} entry_t;
+
+#define LOG_MAX (EDGES * 8)
+typedef struct{
+    entry_t e[ LOG_MAX ];
+    int     count;
+    double  sq_err;  // predicted vs ideal next edge, while locked & steady
+    double  sq_raw;  // last edge + last interval vs ideal next edge
+    double  max_err;
+    int     scored;
+} log_t;
+
+static void log_entry( log_t* log, int coro )
+{
+    if( log->count >= LOG_MAX ){ return; }
+    entry_t* e = &log->e[log->count++];
+    memset( e, 0, sizeof(entry_t) ); // padding too, so logs compare with memcmp
+    e->time   = sample_time;
+    e->beats  = clock_get_time_beats();
+    e->tempo  = clock_get_tempo();
+    e->error  = clock_crow_error();
+    e->locked = clock_crow_locked();
+    e->coro   = coro;
+}
+
+static double crow_raw_prev; // time of the previous edge, as detected
+
+// edge i & its neighbours are evenly spaced, so the next edge is predictable
+static bool steady( int i )
+{
+    if( i < 1 || i+1 >= EDGES ){ return false; }
+    if( ideal[i-1] == 0.0 || ideal[i] == 0.0 || ideal[i+1] == 0.0 ){ return false; }
+    return fabs( (ideal[i+1] - ideal[i]) - (ideal[i] - ideal[i-1]) ) < 1e-9;
+}
+
+static void replay( log_t* log )
+{
+    // all clock state starts afresh, as after a reset
+    free( clock_pool );
+    free( heap );
+    sample_time = 0;
+    memset( jitter, 0, sizeof(jitter) );
+    memset( log, 0, sizeof(log_t) );
+    woken_count = 0;
+    crow_raw_prev = 0.0;
+
+    clock_init( CORO_MAX );
+    clock_crow_smoothing( 0.75 );
+    clock_crow_in_div( 1.0 / PPQN );
+    clock_set_source( CLOCK_SOURCE_CROW );
+    clock_schedule_resume_sync( 1, 0.25 );
+    clock_schedule_resume_sync( 2, 1.0 );
+
+    int next = 0;
+    while( next < EDGES ){
+        sample_time += BLOCK;
+        clock_block();
+        bool edge = false;
+        while( next < EDGES && edges[next] < sample_time ){ // detected at the block's end
+            clock_crow_handle_clock();
+            if( clock_crow_locked() && steady(next) && steady(next-1) ){
+                double predicted = reference.last_beat_time
+                                 + (double)reference.beat_duration / PPQN;
+                double err = fabs( predicted - ideal[next+1] );
+                log->sq_err += err * err;
+                if( err > log->max_err ){ log->max_err = err; }
+                double last = (double)sample_time / RATE;
+                double raw = last + (last - crow_raw_prev) - ideal[next+1];
+                log->sq_raw += raw * raw;
+                log->scored++;
+            }
+            crow_raw_prev = (double)sample_time / RATE;
+            next++;
+            edge = true;
+        }
+        if( edge ){ log_entry( log, 0 ); }
+        // event loop: each coroutine syncs again as soon as it resumes
+        for( int i=0; i<woken_count; i++ ){
+            log_entry( log, woken[i] );
+            clock_schedule_resume_sync( woken[i], (woken[i] == 1) ? 0.25 : 1.0 );
+        }
+        woken_count = 0;
+    }
+}
+
+static log_t first, second, changed;
+
+int main( void )
+{
+    int errors = 0;
+    record();
+    replay( &first );
+    replay( &second );
+    if( first.count != second.count
+     || memcmp( first.e, second.e, sizeof(entry_t) * first.count ) ){
+        printf( "clock: replays of one recording differ\n" );
+        errors++;
+    }
+
+    edges[500] += BLOCK; // one block later
+    replay( &changed );
+    if( changed.count == first.count
+     && !memcmp( changed.e, first.e, sizeof(entry_t) * first.count ) ){
+        printf( "clock: a changed recording replayed identically\n" );
+        errors++;
+    }
+
+    double rms = sqrt( first.sq_err / first.scored );
+    double raw = sqrt( first.sq_raw / first.scored );
+    printf( "clock: %d log entries. next edge predicted within %.3fms rms, %.3fms max (raw edges %.3fms rms) over %d locked edges\n"
+          , first.count, rms * 1000.0, first.max_err * 1000.0, raw * 1000.0, first.scored );
+    if( first.scored < EDGES/2 || rms >= raw ){
+        printf( "clock: tempo tracking is no better than the raw edges\n" );
+        errors++;
+    }
+
+    if( errors ){
+        printf( "clock: FAILED\n" );
+        return 1;
+    }
+    printf( "clock: ok\n" );
+    return 0;
+}
@@ -0,0 +1,164 @@
+// stress test for the event queue: lock-free rings & locked fallback lanes
+// threads stand in for the audio, i2c & timer ISRs, each posting to its own
+// rings, plus two 'system exception' threads sharing the locked lanes.
+// the main thread is the consumer. checks that each producer's events arrive
+// in order, that every failed post is counted as dropped, & that the ring
+// indices survive wrapping
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sched.h>
+
+#include "lib/events.c"
+
+void Caw_send_luachunk( char* text ){ UNUSED(text); }
+
+#define POSTS 100000 // per producer & lane. well past the 16bit ring indices
+
+typedef struct{
+    const char* name;
+    uint32_t ipsr;
+    uint32_t priority;
+    uint32_t failed; // posts refused while the lane was full
+} producer_t;
+
+static producer_t producers[] =
+    { { "audio",  16+1,  DAC_IRQPriority }
+    , { "i2c",    16+2,  I2C_Priority    }
+    , { "timer",  16+3,  TIM_IRQPriority }
+    , { "fault",  4,     0               } // system exceptions share the locked lanes
+    , { "systick",15,    0               }
+    };
+#define PRODUCERS (int)(sizeof(producers)/sizeof(producers[0]))
+
+static int expected[ PRODUCERS ][ EVENT_LANE_COUNT ];
+static int errors = 0;
+static volatile int running = 0;
+
+static void handle( event_t* e )
+{
+    int p = e->index.i / EVENT_LANE_COUNT;
+    int lane = e->index.i % EVENT_LANE_COUNT;
+    if( e->data.i != expected[p][lane] ){
+        if( errors++ < 10 ){
+            fprintf( stderr, "%s lane %d: got %d, expected %d\n"
+                   , producers[p].name, lane, e->data.i, expected[p][lane] );
+        }
+    }
+    expected[p][lane] = e->data.i + 1;
+}
+
+static void* produce( void* arg )
+{
+    producer_t* p = arg;
+    host_ipsr = p->ipsr;
+    host_priority = p->priority;
+    int id = (int)(p - producers);
+    for( int i=0; i<POSTS; i++ ){
+        for( int lane=0; lane<EVENT_LANE_COUNT; lane++ ){
+            event_t e = { .handler = handle
+                        , .index.i = id * EVENT_LANE_COUNT + lane
+                        , .data.i  = i
+                        };
+            while( !event_post_lane( &e, lane ) ){ // full. wait for the consumer
+                p->failed++;
+                sched_yield();
+            }
+        }
+    }
+    __sync_fetch_and_sub( &running, 1 );
+    return NULL;
+}
+
+static uint32_t total_dropped( void )
+{
+    uint32_t d = 0;
+    for( int lane=0; lane<EVENT_LANE_COUNT; lane++ ){
+        d += events_get_lane_stats( lane ).dropped;
+    }
+    return d;
+}
+
+#define CHECK(cond, ...) do{ if( !(cond) ){ fprintf(stderr, __VA_ARGS__); errors++; } }while(0)
+
+// a lane refuses posts once full, & counts each refusal
+static void full_lanes( void )
+{
+    struct{ const char* name; uint32_t ipsr, priority; int capacity; } ctx[] =
+        { { "ring",   16+1, DAC_IRQPriority, RING_TIMING_EVENTS - 1 } // one slot kept empty
+        , { "locked", 4,    0,               TIMING_EVENTS - 1      }
+        };
+    for( int c=0; c<2; c++ ){
+        host_ipsr = ctx[c].ipsr;
+        host_priority = ctx[c].priority;
+        uint32_t dropped = total_dropped();
+        int accepted = 0;
+        for( int i=0; i<ctx[c].capacity + 5; i++ ){
+            event_t e = { .handler = handle, .index.i = 0, .data.i = accepted };
+            accepted += event_post( &e );
+        }
+        host_ipsr = 0;
+        CHECK( accepted == ctx[c].capacity, "%s lane took %d of %d\n"
+             , ctx[c].name, accepted, ctx[c].capacity );
+        CHECK( total_dropped() - dropped == 5, "%s lane counted %u drops, not 5\n"
+             , ctx[c].name, total_dropped() - dropped );
+        expected[0][EVENT_LANE_Timing] = 0;
+        int handled = 0;
+        while( event_next() ){ handled++; }
+        CHECK( handled == accepted, "%s lane handled %d of %d\n"
+             , ctx[c].name, handled, accepted );
+    }
+}
+
+int main( void )
+{
+    // every refused post prints 'event queue full!'. keep the report readable
+    fflush( stdout );
+    int out = dup( 1 );
+    int null = open( "/dev/null", O_WRONLY );
+    dup2( null, 1 );
+
+    events_init();
+    full_lanes();
+
+    for( int p=0; p<PRODUCERS; p++ ){
+        for( int lane=0; lane<EVENT_LANE_COUNT; lane++ ){ expected[p][lane] = 0; }
+    }
+    uint32_t dropped = total_dropped();
+    pthread_t threads[ PRODUCERS ];
+    running = PRODUCERS;
+    for( int p=0; p<PRODUCERS; p++ ){
+        pthread_create( &threads[p], NULL, produce, &producers[p] );
+    }
+    while( running ){
+        if( !event_next() ){ sched_yield(); }
+    }
+    for( int p=0; p<PRODUCERS; p++ ){ pthread_join( threads[p], NULL ); }
+    while( event_next() ){}
+
+    fflush( stdout );
+    dup2( out, 1 );
+    close( null );
+
+    uint32_t failed = 0;
+    for( int p=0; p<PRODUCERS; p++ ){
+        failed += producers[p].failed;
+        for( int lane=0; lane<EVENT_LANE_COUNT; lane++ ){
+            CHECK( expected[p][lane] == POSTS, "%s lane %d: %d of %d events\n"
+                 , producers[p].name, lane, expected[p][lane], POSTS );
+        }
+    }
+    CHECK( total_dropped() - dropped == failed, "%u drops counted for %u refused posts\n"
+         , total_dropped() - dropped, failed );
+
+    printf( "events: %d producers x %d lanes x %d events, %u refused while full\n"
+          , PRODUCERS, EVENT_LANE_COUNT, POSTS, failed );
+    if( errors ){
+        printf( "events: FAILED (%d errors)\n", errors );
+        return 1;
+    }
+    printf( "events: ok\n" );
+    return 0;
+}
@@ -0,0 +1,92 @@
+// cost of IO_BlockProcess at each block size
+// every slope loops between -5V & +5V through a mix of shapes, each virtual
+// is mixed into an output, and two outputs are quantized. inputs are idle &
+// no clocks or metros are running. the same stretch of audio is processed at
+// each size, reported per block & per sample against the per-sample budget
+
+#include <stdio.h>
+#include <math.h>
+#undef M_PI // shapes.c defines its own
+#undef M_PI_2
+
+#include "lib/shapes.c"
+#include "lib/slopes.c"
+#include "lib/ashapes.c"
+#include "lib/io.c"
+
+#define SECONDS 20 // of audio at each size
+
+// hardware & the rest of the firmware, as far as IO_BlockProcess reaches
+static int adda_block_size;
+uint16_t ADDA_Init( int adc_timer_ix, int sample_rate, int block_size ){
+    UNUSED(adc_timer_ix); UNUSED(sample_rate);
+    adda_block_size = block_size;
+    return block_size;
+}
+int ADDA_GetSampleRate( void ){ return ADDA_SAMPLE_RATE; }
+void ADDA_Start( void ){}
+float ADDA_GetADCValue( uint8_t channel ){ UNUSED(channel); return 0.0f; }
+
+static void detect_none( Detect_t* self, float level ){ UNUSED(self); UNUSED(level); }
+static Detect_t detectors[ IN_CHANNELS ];
+void Detect_init( int channels, float block_rate ){
+    UNUSED(block_rate);
+    for( int j=0; j<channels; j++ ){ detectors[j].modefn = detect_none; }
+}
+Detect_t* Detect_ix_to_p( uint8_t index ){ return &detectors[index]; }
+
+Casl* casl_init( int index ){ UNUSED(index); return NULL; }
+void clock_block( void ){}
+void Metro_block( void ){}
+void Caw_printf( char* text, ... ){ UNUSED(text); }
+
+// each slope turns around at every breakpoint, as an lfo{} does
+static const Shape_t shape_of[] = { SHAPE_Sine, SHAPE_Over, SHAPE_Rebound, SHAPE_Linear
+                                  , SHAPE_Expo, SHAPE_Log,  SHAPE_Under,   SHAPE_Sine };
+static void turn( int index )
+{
+    S_toward( index, -S_get_state(index) // -5V <-> +5V
+            , 2.0f + (float)(index % 5) * 1.5f, shape_of[index % 8], turn );
+}
+
+static void setup( int block_size )
+{
+    IO_Init( 0, ADDA_SAMPLE_RATE, block_size );
+    for( int j=0; j<SLOPE_CHANNELS; j++ ){
+        S_toward( j, 5.0f, 0.0f, SHAPE_Linear, NULL );
+        turn( j );
+    }
+    for( int k=0; k<SLOPE_VIRTUALS; k++ ){
+        IO_SetVirtualMix( k % SLOPE_OUTPUTS, k, 0.5f );
+    }
+    float major[] = { 0, 2, 4, 5, 7, 9, 11 };
+    AShaper_set_scale( 0, major, 7, 12.0f, 1.0f );
+    AShaper_set_scale( 1, major, 7, 12.0f, 1.0f );
+}
+
+static IO_block_t block;
+
+int main( void )
+{
+    static const int sizes[] = { 1, 8, 16, 32, 64, 128 };
+    const double budget = (double)SystemCoreClock / ADDA_SAMPLE_RATE;
+    printf( "io: IO_BlockProcess, %d outputs & %d virtuals. %ds of audio @%dHz\n"
+          , SLOPE_OUTPUTS, SLOPE_VIRTUALS, SECONDS, ADDA_SAMPLE_RATE );
+    printf( "%6s %14s %14s %10s\n", "block", "cycles/block", "cycles/sample", "of budget" );
+    for( unsigned s=0; s<sizeof(sizes)/sizeof(sizes[0]); s++ ){
+        setup( sizes[s] );
+        block.size = adda_block_size;
+        int blocks = SECONDS * ADDA_SAMPLE_RATE / block.size;
+        uint64_t cycles = 0;
+        for( int b=0; b<blocks; b++ ){
+            uint32_t start = DWT->CYCCNT;
+            IO_BlockProcess( &block );
+            cycles += DWT->CYCCNT - start;
+        }
+        double per_sample = (double)cycles / ((double)blocks * block.size);
+        printf( "%6d %14.1f %14.1f %9.1f%%\n"
+              , block.size, (double)cycles / blocks, per_sample
+              , 100.0 * per_sample / budget );
+    }
+    return 0;
+}
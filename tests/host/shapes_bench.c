@@ -0,0 +1,85 @@
+// throughput of each shaper: tables against libm, single sample & vector
+// reported as host cycles per sample, counted at SystemCoreClock
+
+#include <stdio.h>
+
+#include "stm32f7xx.h" // DWT->CYCCNT
+#include "shapes_libm.h"
+
+#define BLOCK  32     // samples per call to the vector shapers
+#define BLOCKS 200000 // ~6.4M samples per measurement
+
+typedef struct{
+    const char* name;
+    float  (*fn)( float );
+    float* (*fn_v)( float*, int );
+} shaper_t;
+
+static const shaper_t shapers[][2] = // { libm, firmware }
+    { { { "sin",         libm_sin,               libm_v_sin               }
+      , { "sin",         shapes_sin,             shapes_v_sin             } }
+    , { { "exp",         libm_exp,               libm_v_exp               }
+      , { "exp",         shapes_exp,             shapes_v_exp             } }
+    , { { "log",         libm_log,               libm_v_log               }
+      , { "log",         shapes_log,             shapes_v_log             } }
+    , { { "now",         libm_step_now,          libm_v_step_now          }
+      , { "now",         shapes_step_now,        shapes_v_step_now        } }
+    , { { "wait",        libm_step_wait,         libm_v_step_wait         }
+      , { "wait",        shapes_step_wait,       shapes_v_step_wait       } }
+    , { { "over",        libm_ease_in_back,      libm_v_ease_in_back      }
+      , { "over",        shapes_ease_in_back,    shapes_v_ease_in_back    } }
+    , { { "under",       libm_ease_out_back,     libm_v_ease_out_back     }
+      , { "under",       shapes_ease_out_back,   shapes_v_ease_out_back   } }
+    , { { "rebound",     libm_ease_out_rebound,  libm_v_ease_out_rebound   }
+      , { "rebound",     shapes_ease_out_rebound, shapes_v_ease_out_rebound } }
+    };
+#define SHAPERS (int)(sizeof(shapers)/sizeof(shapers[0]))
+
+static volatile float sink; // keeps results live
+
+static float ramp( int b, int i ){ return (float)((b * BLOCK + i) & 0xFFFF) / 65536.0f; }
+
+static double per_sample( const shaper_t* s )
+{
+    float acc = 0.0f;
+    uint32_t start = DWT->CYCCNT;
+    for( int b=0; b<BLOCKS; b++ ){
+        for( int i=0; i<BLOCK; i++ ){
+            acc += s->fn( ramp( b, i ) );
+        }
+    }
+    uint32_t cycles = DWT->CYCCNT - start;
+    sink = acc;
+    return (double)cycles / (double)(BLOCKS * BLOCK);
+}
+
+static double vector( const shaper_t* s )
+{
+    float buf[ BLOCK ];
+    float acc = 0.0f;
+    uint32_t start = DWT->CYCCNT;
+    for( int b=0; b<BLOCKS; b++ ){
+        for( int i=0; i<BLOCK; i++ ){ buf[i] = ramp( b, i ); }
+        acc += s->fn_v( buf, BLOCK )[BLOCK-1];
+    }
+    uint32_t cycles = DWT->CYCCNT - start;
+    sink = acc;
+    return (double)cycles / (double)(BLOCKS * BLOCK);
+}
+
+int main( void )
+{
+    printf( "shapes: cycles/sample @%uMHz. %d blocks of %d\n"
+          , (unsigned)(SystemCoreClock / 1000000), BLOCKS, BLOCK );
+    printf( "%-8s %10s %10s %10s %10s\n", "shape", "libm", "table", "libm_v", "table_v" );
+    for( int s=0; s<SHAPERS; s++ ){
+        printf( "%-8s %10.2f %10.2f %10.2f %10.2f\n"
+              , shapers[s][0].name
+              , per_sample( &shapers[s][0] )
+              , per_sample( &shapers[s][1] )
+              , vector( &shapers[s][0] )
+              , vector( &shapers[s][1] )
+              );
+    }
+    return 0;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+// shapes.c built twice in one file: first with SHAPES_LIBM under libm_ names
+// as the reference, then as the firmware builds it with the usual names
+
+#include <math.h>
+#undef M_PI // shapes.c defines its own
+#undef M_PI_2
+
+#define shapes_sin                libm_sin
+#define shapes_log                libm_log
+#define shapes_exp                libm_exp
+#define shapes_step_now           libm_step_now
+#define shapes_step_wait          libm_step_wait
+#define shapes_ease_in_back       libm_ease_in_back
+#define shapes_ease_out_back      libm_ease_out_back
+#define shapes_ease_out_rebound   libm_ease_out_rebound
+#define shapes_v_sin              libm_v_sin
+#define shapes_v_log              libm_v_log
+#define shapes_v_exp              libm_v_exp
+#define shapes_v_step_now         libm_v_step_now
+#define shapes_v_step_wait        libm_v_step_wait
+#define shapes_v_ease_in_back     libm_v_ease_in_back
+#define shapes_v_ease_out_back    libm_v_ease_out_back
+#define shapes_v_ease_out_rebound libm_v_ease_out_rebound
+#define SHAPES_LIBM
+#include "lib/shapes.c"
+#undef SHAPES_LIBM
+#undef shapes_sin
+#undef shapes_log
+#undef shapes_exp
+#undef shapes_step_now
+#undef shapes_step_wait
+#undef shapes_ease_in_back
+#undef shapes_ease_out_back
+#undef shapes_ease_out_rebound
+#undef shapes_v_sin
+#undef shapes_v_log
+#undef shapes_v_exp
+#undef shapes_v_step_now
+#undef shapes_v_step_wait
+#undef shapes_v_ease_in_back
+#undef shapes_v_ease_out_back
+#undef shapes_v_ease_out_rebound
+#undef M_PI
+#undef M_PI_2
+#include "lib/shapes.c"
@@ -0,0 +1,69 @@
+// accuracy of the interpolated shape tables against the libm shapers
+// sweeps [0,1] for sin, exp & log through both the single sample & vector paths
+
+#include <stdio.h>
+#include <math.h>
+
+#include "shapes_libm.h"
+
+// linear interpolation of exp over 512 segments is within 2.3e-5
+// the rest is float rounding in the reference itself
+#define MAX_ERROR 3e-5
+#define STEPS     100000 // points swept across [0,1]
+#define BLOCK     32
+
+typedef struct{
+    const char* name;
+    float  (*lut)( float );
+    float  (*ref)( float );
+    float* (*lut_v)( float*, int );
+} shape_t;
+
+static const shape_t shapes[] =
+    { { "sin", shapes_sin, libm_sin, shapes_v_sin }
+    , { "exp", shapes_exp, libm_exp, shapes_v_exp }
+    , { "log", shapes_log, libm_log, shapes_v_log }
+    };
+
+int main( void )
+{
+    int errors = 0;
+    if( SHAPES_LUT_SIZE != 512 ){
+        printf( "shapes: tables have %d segments. bound is for 512\n", SHAPES_LUT_SIZE );
+        errors++;
+    }
+    for( int s=0; s<3; s++ ){
+        const shape_t* sh = &shapes[s];
+        double worst = 0.0, worst_v = 0.0;
+        float worst_at = 0.0;
+        float block[ BLOCK ];
+        for( int i=0; i<=STEPS; i += BLOCK ){
+            int n = (i+BLOCK <= STEPS+1) ? BLOCK : STEPS+1 - i;
+            for( int k=0; k<n; k++ ){
+                float x = (float)(i+k) / (float)STEPS;
+                double ref = (double)sh->ref( x );
+                double e = fabs( (double)sh->lut( x ) - ref );
+                if( e > worst ){ worst = e; worst_at = x; }
+                block[k] = x;
+            }
+            sh->lut_v( block, n );
+            for( int k=0; k<n; k++ ){
+                float x = (float)(i+k) / (float)STEPS;
+                double e = fabs( (double)block[k] - (double)sh->ref( x ) );
+                if( e > worst_v ){ worst_v = e; }
+            }
+        }
+        printf( "shapes: %s max error %.2e at %.5f, vector %.2e\n"
+              , sh->name, worst, (double)worst_at, worst_v );
+        if( worst > MAX_ERROR || worst_v > MAX_ERROR ){
+            printf( "shapes: %s exceeds %.1e\n", sh->name, MAX_ERROR );
+            errors++;
+        }
+    }
+    if( errors ){
+        printf( "shapes: FAILED\n" );
+        return 1;
+    }
+    printf( "shapes: ok\n" );
+    return 0;
+}
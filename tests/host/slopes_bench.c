@@ -0,0 +1,67 @@
+// cost of shaping a block of slope output, per Shape_t: the per-sample
+// shaper() used at breakpoints, looped over the block, against shaper_v
+
+#include <stdio.h>
+#include <math.h>
+#undef M_PI // shapes.c defines its own
+#undef M_PI_2
+
+#include "lib/shapes.c"
+#include "lib/slopes.c"
+
+#define BLOCK  32     // samples per audio block
+#define BLOCKS 200000
+
+static volatile float sink; // keeps results live
+
+static const char* names[] =
+    { "linear", "sine", "log", "expo", "now", "wait", "over", "under", "rebound" };
+
+static void ramp( float* buf, int b )
+{
+    for( int i=0; i<BLOCK; i++ ){
+        buf[i] = (float)((b * BLOCK + i) & 0xFFFF) / 65536.0f;
+    }
+}
+
+static double per_sample( Slope_t* s )
+{
+    float buf[ BLOCK ];
+    float acc = 0.0f;
+    uint32_t start = DWT->CYCCNT;
+    for( int b=0; b<BLOCKS; b++ ){
+        ramp( buf, b );
+        for( int i=0; i<BLOCK; i++ ){ buf[i] = shaper( s, buf[i] ); }
+        acc += buf[BLOCK-1];
+    }
+    uint32_t cycles = DWT->CYCCNT - start;
+    sink = acc;
+    return (double)cycles / BLOCKS;
+}
+
+static double vector( Slope_t* s )
+{
+    float buf[ BLOCK ];
+    float acc = 0.0f;
+    uint32_t start = DWT->CYCCNT;
+    for( int b=0; b<BLOCKS; b++ ){
+        ramp( buf, b );
+        acc += shaper_v( s, buf, BLOCK )[BLOCK-1];
+    }
+    uint32_t cycles = DWT->CYCCNT - start;
+    sink = acc;
+    return (double)cycles / BLOCKS;
+}
+
+int main( void )
+{
+    Slope_t s = { .last = -2.0f, .scale = 7.0f }; // a -2V to +5V segment
+    printf( "slopes: cycles/block of %d @%uMHz. %d blocks\n"
+          , BLOCK, (unsigned)(SystemCoreClock / 1000000), BLOCKS );
+    printf( "%-8s %10s %10s\n", "shape", "shaper", "shaper_v" );
+    for( Shape_t sh=SHAPE_Linear; sh<=SHAPE_Rebound; sh++ ){
+        s.shape = sh;
+        printf( "%-8s %10.1f %10.1f\n", names[sh], per_sample( &s ), vector( &s ) );
+    }
+    return 0;
+}
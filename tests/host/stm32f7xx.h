@@ -0,0 +1,80 @@
+#pragma once
+
+// host stand-in for the CMSIS device header, so lib/ builds natively for
+// tests & benchmarks. threads stand in for ISRs: each sets the exception
+// number & priority it runs at, and masking IRQs takes one global lock
+
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+
+#define __weak __attribute__((weak))
+#define UNUSED(x) ((void)(x))
+
+static pthread_mutex_t host_irq_lock;
+static __thread uint32_t host_ipsr     = 0; // 0 in thread mode. IRQn+16 in an 'ISR'
+static __thread uint32_t host_priority = 0; // preempt priority of the running 'ISR'
+static __thread uint32_t host_masked   = 0;
+
+__attribute__((constructor)) static void host_irq_init( void )
+{
+    pthread_mutexattr_t a;
+    pthread_mutexattr_init( &a );
+    pthread_mutexattr_settype( &a, PTHREAD_MUTEX_RECURSIVE );
+    pthread_mutex_init( &host_irq_lock, &a );
+}
+
+// each BLOCK_IRQS disables once & restores once, so the lock nests with it
+static inline uint32_t __get_PRIMASK( void ){ return host_masked; }
+static inline void __disable_irq( void )
+{
+    pthread_mutex_lock( &host_irq_lock );
+    host_masked++;
+}
+static inline void __set_PRIMASK( uint32_t primask )
+{
+    UNUSED(primask);
+    host_masked--;
+    pthread_mutex_unlock( &host_irq_lock );
+}
+
+#define BLOCK_IRQS(code) do{ \
+                            uint32_t old_primask = __get_PRIMASK(); \
+                            __disable_irq(); \
+                            do{code} while(0); \
+                            __set_PRIMASK( old_primask ); \
+                        } while(0);
+
+static inline void __DMB( void ){ __sync_synchronize(); }
+
+typedef int IRQn_Type;
+static inline uint32_t __get_IPSR( void ){ return host_ipsr; }
+static inline uint32_t NVIC_GetPriority( IRQn_Type irq ){ UNUSED(irq); return host_priority; }
+
+// the cycle counter follows the monotonic clock, at the core's rate
+static uint32_t SystemCoreClock = 216000000;
+
+typedef struct{
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+typedef struct{
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+static DWT_Type host_dwt_regs __attribute__((unused));
+static CoreDebug_Type host_coredebug_regs __attribute__((unused));
+
+static inline DWT_Type* host_dwt( void )
+{
+    struct timespec t;
+    clock_gettime( CLOCK_MONOTONIC, &t );
+    uint64_t ns = (uint64_t)t.tv_sec * 1000000000u + (uint64_t)t.tv_nsec;
+    host_dwt_regs.CYCCNT = (uint32_t)( ns * (SystemCoreClock / 1000000) / 1000 );
+    return &host_dwt_regs;
+}
+
+#define DWT       (host_dwt())
+#define CoreDebug (&host_coredebug_regs)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk     (1UL)
@@ -0,0 +1,18 @@
+#pragma once
+
+// host stand-in for the HAL. see stm32f7xx.h
+
+#include "stm32f7xx.h"
+
+static inline uint32_t HAL_GetTick( void )
+{
+    struct timespec t;
+    clock_gettime( CLOCK_MONOTONIC, &t );
+    return (uint32_t)( (uint64_t)t.tv_sec * 1000u + (uint64_t)t.tv_nsec / 1000000u );
+}
+
+static inline void HAL_Delay( uint32_t ms )
+{
+    struct timespec t = { .tv_sec = ms / 1000, .tv_nsec = (long)(ms % 1000) * 1000000 };
+    nanosleep( &t, NULL );
+}
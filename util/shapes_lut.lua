@@ -0,0 +1,51 @@
+-- generates the interpolation tables for lib/shapes.c
+-- each table covers the input range [0,1] with LUT_SIZE segments
+-- plus a guard point so interpolation can always read ix+1
+
+LUT_SIZE = 512
+
+header = [[
+// THIS FILE IS AUTOGENERATED //
+// DO NOT EDIT THIS MANUALLY //
+
+#pragma once
+
+]]
+
+-- must match the libm shapers in lib/shapes.c
+shapes =
+    { { name = 'sin', fn = function(x) return -0.5 * (math.cos(math.pi * x) - 1.0) end }
+    , { name = 'exp', fn = function(x) return 2.0^(10.0 * (x - 1.0)) end }
+    -- log is 1-exp(1-x) so shares the exp table
+    }
+
+function make_table(shape)
+    local c = 'static const float shapes_lut_' .. shape.name
+           .. '[SHAPES_LUT_SIZE+1] =\n    { '
+    for i=0,LUT_SIZE do
+        if i > 0 then
+            c = c .. ((i % 4 == 0) and '\n    , ' or ', ')
+        end
+        c = c .. string.format('%.9e', shape.fn(i / LUT_SIZE))
+    end
+    return c .. '\n    };\n\n'
+end
+
+function make_c()
+    local c = header .. '#define SHAPES_LUT_SIZE ' .. LUT_SIZE .. '\n\n'
+    for _,s in ipairs(shapes) do
+        c = c .. make_table(s)
+    end
+    return c
+end
+
+local out_file = arg[1]
+
+do
+    local c = io.open( out_file, 'w' )
+    c:write(make_c())
+    c:close()
+end
+
+-- example usage:
+-- lua util/shapes_lut.lua build/shapes_lut.h